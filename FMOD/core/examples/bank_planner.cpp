@@ -0,0 +1,662 @@
+/*==============================================================================
+FSBank Format Planner Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how to split a set of assets into PCM, FADPCM, Vorbis
+and Opus banks from how often each one is played, instead of building a
+single bank with one FSBANK_FORMAT for everything.
+
+Hot, frequently triggered sounds cost CPU every time they are decoded,
+long and rarely played sounds mostly cost memory. For every asset and
+format the example:
+
+ * Encodes the asset with FSBank into memory and keeps the bank size.
+ * Decodes it with Sound::readData on this machine and times it, giving
+   the decode cost per second of audio.
+ * Loads it with FMOD_CREATECOMPRESSEDSAMPLE and plays one voice, giving
+   the resident memory and the memory added per voice.
+
+Play statistics (plays per minute and the most voices at once) are read
+from bank_stats.txt, a template is written with example values when the
+file is missing. The average number of voices of an asset is its plays
+per second times its length, capped by its voice limit.
+
+The planner starts every asset in its smallest format and moves assets to
+cheaper formats, best CPU saved per byte first, until the projected decode
+CPU fits the budget. Any memory left under the memory budget is then spent
+the same way. ACTION1 builds one bank per format and writes bank_plan.txt
+with the projected runtime CPU and memory of the plan.
+
+Decode costs only cover decoding, mixing costs the same for every format.
+The first voice of a codec can also allocate part of its codec pool, so
+per voice memory is an upper bound.
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod.hpp"
+#include "common.h"
+#include "fsbank.h"
+#include "fsbank_errors.h"
+#include <stdio.h>
+#include <string.h>
+
+#define PLANNER_MAX_ASSETS          64
+#define PLANNER_QUALITY             60          /* Vorbis and Opus quality, 1 to 100 */
+#define PLANNER_MEASURE_SECONDS     4.0f        /* Minimum audio decoded per measurement */
+#define PLANNER_STATS_NAME          "bank_stats.txt"
+#define PLANNER_REPORT_NAME         "bank_plan.txt"
+#define PLANNER_LIST_LINES          10
+
+#define FBCHECK(_result) FBCHECK_fn(_result, __FILE__, __LINE__)
+
+void FBCHECK_fn(FSBANK_RESULT result, const char *file, int line)
+{
+    if (result != FSBANK_OK)
+    {
+        Common_Fatal("%s(%d): FSBank error %d - %s", file, line, result, FSBank_ErrorString(result));
+    }
+}
+
+enum PlanFormat
+{
+    PLAN_PCM,
+    PLAN_FADPCM,
+    PLAN_VORBIS,
+    PLAN_OPUS,
+    PLAN_FORMAT_COUNT
+};
+
+struct FormatInfo
+{
+    const char     *name;
+    FSBANK_FORMAT   format;
+    const char     *bankName;
+};
+
+static const FormatInfo gFormats[PLAN_FORMAT_COUNT] =
+{
+    { "PCM",    FSBANK_FORMAT_PCM,    "planned_pcm.fsb"    },
+    { "FADPCM", FSBANK_FORMAT_FADPCM, "planned_fadpcm.fsb" },
+    { "Vorbis", FSBANK_FORMAT_VORBIS, "planned_vorbis.fsb" },
+    { "Opus",   FSBANK_FORMAT_OPUS,   "planned_opus.fsb"   },
+};
+
+/*
+    Written to bank_stats.txt when it does not exist. Replace with numbers captured from the game.
+*/
+struct AssetStats
+{
+    const char  *name;
+    float        playsPerMinute;
+    int          maxVoices;
+};
+
+static const AssetStats gDefaultStats[] =
+{
+    { "swish.wav",      120.0f, 8 },
+    { "jaguar.wav",      30.0f, 4 },
+    { "c.ogg",           60.0f, 6 },
+    { "d.ogg",           60.0f, 6 },
+    { "e.ogg",           60.0f, 6 },
+    { "drumloop.wav",     4.0f, 2 },
+    { "standrews.wav",    2.0f, 1 },
+    { "singing.wav",      1.0f, 1 },
+    { "stereo.ogg",       0.5f, 1 },
+    { "wave.mp3",         0.5f, 1 },
+};
+
+static const int NUM_DEFAULT_STATS = sizeof(gDefaultStats) / sizeof(gDefaultStats[0]);
+
+struct FormatCost
+{
+    bool            valid;
+    unsigned int    bankBytes;
+    int             residentBytes;
+    int             voiceBytes;
+    float           decodeUsPerSecond;          /* Microseconds to decode one second of audio */
+};
+
+struct Asset
+{
+    char            name[64];
+    float           playsPerMinute;
+    int             maxVoices;
+    float           lengthSeconds;
+    float           averageVoices;
+    FormatCost      cost[PLAN_FORMAT_COUNT];
+    int             chosen;
+};
+
+struct PlanTotals
+{
+    float           cpu;                        /* Percent of one core, average voices */
+    float           peakCpu;                    /* Percent of one core, every asset at its voice limit */
+    int             memory;
+    int             assets[PLAN_FORMAT_COUNT];
+};
+
+int loadStats(Asset *assets)
+{
+    int count = 0;
+
+    FILE *file = fopen(Common_MediaPath(PLANNER_STATS_NAME), "r");
+    if (file)
+    {
+        char line[256];
+        while (fgets(line, sizeof(line), file) && count < PLANNER_MAX_ASSETS)
+        {
+            Asset *a = &assets[count];
+            if (line[0] == '#' || sscanf(line, "%63s %f %d", a->name, &a->playsPerMinute, &a->maxVoices) != 3)
+            {
+                continue;
+            }
+            a->maxVoices = Common_Max(a->maxVoices, 1);
+            count++;
+        }
+        fclose(file);
+        return count;
+    }
+
+    file = fopen(Common_WritePath(PLANNER_STATS_NAME), "w");
+    if (file)
+    {
+        fprintf(file, "# Play statistics for the FMOD bank planner example\n");
+        fprintf(file, "# <file in media folder> <plays per minute> <max voices at once>\n");
+    }
+    for (int i = 0; i < NUM_DEFAULT_STATS; i++)
+    {
+        Asset *a = &assets[count++];
+        strcpy(a->name, gDefaultStats[i].name);
+        a->playsPerMinute = gDefaultStats[i].playsPerMinute;
+        a->maxVoices = gDefaultStats[i].maxVoices;
+        if (file)
+        {
+            fprintf(file, "%s %g %d\n", a->name, a->playsPerMinute, a->maxVoices);
+        }
+    }
+    if (file)
+    {
+        fclose(file);
+    }
+    return count;
+}
+
+/*
+    Encode one asset in one format and measure what it would cost at runtime.
+*/
+void measureAsset(FMOD::System *system, Asset *asset, int format)
+{
+    FMOD_RESULT             result;
+    FSBANK_RESULT           fbresult;
+    FSBANK_SUBSOUND         subsound;
+    FMOD_CREATESOUNDEXINFO  exinfo;
+    FMOD::Sound            *bank, *sound;
+    FMOD::Channel          *channel;
+    FormatCost             *cost = &asset->cost[format];
+    const char             *path = Common_MediaPath(asset->name);
+    const void             *data;
+    unsigned int            length;
+
+    memset(cost, 0, sizeof(FormatCost));
+    memset(&subsound, 0, sizeof(subsound));
+    subsound.fileNames = &path;
+    subsound.numFiles = 1;
+
+    /*
+        Some formats reject some inputs (for example sample rates Opus does not support), leave those out of the plan
+    */
+    fbresult = FSBank_Build(&subsound, 1, gFormats[format].format, FSBANK_BUILD_DEFAULT, PLANNER_QUALITY, NULL, NULL);
+    if (fbresult != FSBANK_OK)
+    {
+        return;
+    }
+    fbresult = FSBank_FetchFSBMemory(&data, &length);
+    FBCHECK(fbresult);
+    cost->bankBytes = length;
+
+    memset(&exinfo, 0, sizeof(exinfo));
+    exinfo.cbsize = sizeof(exinfo);
+    exinfo.length = length;
+
+    /*
+        Decode cost, repeat the asset until enough audio has been decoded to time it
+    */
+    result = system->createSound((const char *)data, FMOD_OPENMEMORY | FMOD_OPENONLY, &exinfo, &bank);
+    ERRCHECK(result);
+    result = bank->getSubSound(0, &sound);
+    ERRCHECK(result);
+
+    int channels, bits;
+    float rate;
+    unsigned int lengthms;
+    result = sound->getFormat(0, 0, &channels, &bits);
+    ERRCHECK(result);
+    result = sound->getDefaults(&rate, 0);
+    ERRCHECK(result);
+    result = sound->getLength(&lengthms, FMOD_TIMEUNIT_MS);
+    ERRCHECK(result);
+    asset->lengthSeconds = lengthms / 1000.0f;
+
+    static char buffer[16384];
+    double bytesPerSecond = rate * channels * (bits / 8);
+    double decoded = 0;
+    unsigned int startUs, endUs;
+
+    Common_Time_GetUs(&startUs);
+    while (decoded < PLANNER_MEASURE_SECONDS * bytesPerSecond)
+    {
+        unsigned int read = 0;
+        result = sound->readData(buffer, sizeof(buffer), &read);
+        decoded += read;
+        if (result == FMOD_ERR_FILE_EOF)
+        {
+            result = sound->seekData(0);
+        }
+        ERRCHECK(result);
+    }
+    Common_Time_GetUs(&endUs);
+
+    cost->decodeUsPerSecond = (float)((endUs - startUs) / (decoded / bytesPerSecond));
+
+    result = bank->release();
+    ERRCHECK(result);
+
+    /*
+        Runtime memory, loaded the way the game would load it and with one voice playing
+    */
+    int before, loaded, playing;
+
+    result = FMOD::Memory_GetStats(&before, 0);
+    ERRCHECK(result);
+    result = system->createSound((const char *)data, FMOD_OPENMEMORY | FMOD_CREATECOMPRESSEDSAMPLE, &exinfo, &bank);
+    ERRCHECK(result);
+    result = FMOD::Memory_GetStats(&loaded, 0);
+    ERRCHECK(result);
+
+    result = bank->getSubSound(0, &sound);
+    ERRCHECK(result);
+    result = system->playSound(sound, 0, true, &channel);
+    ERRCHECK(result);
+    result = system->update();
+    ERRCHECK(result);
+    result = FMOD::Memory_GetStats(&playing, 0);
+    ERRCHECK(result);
+
+    result = channel->stop();
+    ERRCHECK(result);
+    result = bank->release();
+    ERRCHECK(result);
+
+    cost->residentBytes = loaded - before;
+    cost->voiceBytes = Common_Max(playing - loaded, 0);
+    cost->valid = true;
+}
+
+float assetCpu(const Asset *asset, int format)
+{
+    return asset->averageVoices * asset->cost[format].decodeUsPerSecond / 10000.0f;
+}
+
+int assetMemory(const Asset *asset, int format)
+{
+    return asset->cost[format].residentBytes + asset->maxVoices * asset->cost[format].voiceBytes;
+}
+
+void computeTotals(const Asset *assets, int numassets, PlanTotals *totals)
+{
+    memset(totals, 0, sizeof(PlanTotals));
+
+    for (int i = 0; i < numassets; i++)
+    {
+        const Asset *a = &assets[i];
+        if (a->chosen < 0)
+        {
+            continue;
+        }
+        totals->cpu += assetCpu(a, a->chosen);
+        totals->peakCpu += a->maxVoices * a->cost[a->chosen].decodeUsPerSecond / 10000.0f;
+        totals->memory += assetMemory(a, a->chosen);
+        totals->assets[a->chosen]++;
+    }
+}
+
+/*
+    Find the move to a cheaper to decode format that saves the most CPU per byte it adds. Moves that also save
+    memory are always taken first. Returns false when there is no move left, or none that fits 'memoryLimit'.
+*/
+bool applyBestMove(Asset *assets, int numassets, int memoryLimit, int currentMemory)
+{
+    int     bestAsset = -1, bestFormat = -1;
+    float   bestRatio = 0.0f;
+    bool    bestSaves = false;
+
+    for (int i = 0; i < numassets; i++)
+    {
+        Asset *a = &assets[i];
+        if (a->chosen < 0)
+        {
+            continue;
+        }
+
+        for (int f = 0; f < PLAN_FORMAT_COUNT; f++)
+        {
+            if (!a->cost[f].valid || f == a->chosen)
+            {
+                continue;
+            }
+
+            float saved = assetCpu(a, a->chosen) - assetCpu(a, f);
+            int   added = assetMemory(a, f) - assetMemory(a, a->chosen);
+            if (saved <= 0.0f || currentMemory + added > memoryLimit)
+            {
+                continue;
+            }
+
+            float ratio = saved / (float)Common_Max(added, 1);
+            bool  saves = added <= 0;
+            if ((saves && !bestSaves) || (saves == bestSaves && ratio > bestRatio))
+            {
+                bestSaves = saves;
+                bestRatio = ratio;
+                bestAsset = i;
+                bestFormat = f;
+            }
+        }
+    }
+
+    if (bestAsset < 0)
+    {
+        return false;
+    }
+
+    assets[bestAsset].chosen = bestFormat;
+    return true;
+}
+
+void plan(Asset *assets, int numassets, float cpuBudget, int memoryBudget, PlanTotals *totals)
+{
+    /*
+        Smallest format first
+    */
+    for (int i = 0; i < numassets; i++)
+    {
+        Asset *a = &assets[i];
+        a->chosen = -1;
+        for (int f = 0; f < PLAN_FORMAT_COUNT; f++)
+        {
+            if (a->cost[f].valid && (a->chosen < 0 || assetMemory(a, f) < assetMemory(a, a->chosen)))
+            {
+                a->chosen = f;
+            }
+        }
+    }
+
+    /*
+        Get under the CPU budget whatever it costs in memory, then spend what is left of the memory budget
+    */
+    computeTotals(assets, numassets, totals);
+    while (totals->cpu > cpuBudget && applyBestMove(assets, numassets, 0x7FFFFFFF, totals->memory))
+    {
+        computeTotals(assets, numassets, totals);
+    }
+    while (applyBestMove(assets, numassets, memoryBudget, totals->memory))
+    {
+        computeTotals(assets, numassets, totals);
+    }
+}
+
+int buildBanks(const Asset *assets, int numassets)
+{
+    const char         *paths[PLANNER_MAX_ASSETS];
+    FSBANK_SUBSOUND     subsounds[PLANNER_MAX_ASSETS];
+    int                 built = 0;
+
+    for (int f = 0; f < PLAN_FORMAT_COUNT; f++)
+    {
+        int count = 0;
+
+        memset(subsounds, 0, sizeof(subsounds));
+        for (int i = 0; i < numassets; i++)
+        {
+            if (assets[i].chosen == f)
+            {
+                paths[count] = Common_MediaPath(assets[i].name);
+                subsounds[count].fileNames = &paths[count];
+                subsounds[count].numFiles = 1;
+                count++;
+            }
+        }
+
+        if (count)
+        {
+            FSBANK_RESULT result = FSBank_Build(subsounds, count, gFormats[f].format, FSBANK_BUILD_DEFAULT, PLANNER_QUALITY, NULL, Common_WritePath(gFormats[f].bankName));
+            FBCHECK(result);
+            built++;
+        }
+    }
+
+    return built;
+}
+
+void writeReport(const Asset *assets, int numassets, float cpuBudget, int memoryBudget, const PlanTotals *totals)
+{
+    FILE *file = fopen(Common_WritePath(PLANNER_REPORT_NAME), "w");
+    if (!file)
+    {
+        return;
+    }
+
+    fprintf(file, "; Generated by the FMOD bank planner example\n");
+    fprintf(file, "[budget]\n");
+    fprintf(file, "cpupercent = %.3f\n", cpuBudget);
+    fprintf(file, "memorybytes = %d\n", memoryBudget);
+
+    fprintf(file, "\n[projected]\n");
+    fprintf(file, "cpupercent = %.3f\n", totals->cpu);
+    fprintf(file, "peakcpupercent = %.3f\n", totals->peakCpu);
+    fprintf(file, "memorybytes = %d\n", totals->memory);
+
+    fprintf(file, "\n[banks]\n");
+    for (int f = 0; f < PLAN_FORMAT_COUNT; f++)
+    {
+        if (totals->assets[f])
+        {
+            fprintf(file, "%s = %d assets\n", gFormats[f].bankName, totals->assets[f]);
+        }
+    }
+
+    fprintf(file, "\n[assets]\n");
+    fprintf(file, "; name, format, plays per minute, max voices, average voices, cpu percent, memory bytes\n");
+    for (int i = 0; i < numassets; i++)
+    {
+        const Asset *a = &assets[i];
+        if (a->chosen < 0)
+        {
+            fprintf(file, "%s, none\n", a->name);
+            continue;
+        }
+        fprintf(file, "%s, %s, %g, %d, %.2f, %.4f, %d\n", a->name, gFormats[a->chosen].name, a->playsPerMinute, a->maxVoices,
+            a->averageVoices, assetCpu(a, a->chosen), assetMemory(a, a->chosen));
+    }
+
+    fprintf(file, "\n[measured]\n");
+    fprintf(file, "; name, format, bank bytes, resident bytes, bytes per voice, decode us per second of audio\n");
+    for (int i = 0; i < numassets; i++)
+    {
+        for (int f = 0; f < PLAN_FORMAT_COUNT; f++)
+        {
+            const FormatCost *c = &assets[i].cost[f];
+            if (c->valid)
+            {
+                fprintf(file, "%s, %s, %u, %d, %d, %.1f\n", assets[i].name, gFormats[f].name, c->bankBytes, c->residentBytes, c->voiceBytes, c->decodeUsPerSecond);
+            }
+        }
+    }
+
+    fclose(file);
+}
+
+int FMOD_Main()
+{
+    FMOD::System       *system;
+    FMOD_RESULT         result;
+    FSBANK_RESULT       fbresult;
+    Asset               assets[PLANNER_MAX_ASSETS];
+    PlanTotals          totals;
+    int                 numassets;
+    int                 measured = 0;
+    int                 built = -1;
+    float               cpuBudget = 1.0f;
+    int                 memoryBudget = 4 * 1024 * 1024;
+    void               *extradriverdata = 0;
+
+    Common_Init(&extradriverdata);
+
+    /*
+        Create a System object and initialize. Nothing is heard, the System only decodes and loads the candidate banks.
+    */
+    result = FMOD::System_Create(&system);
+    ERRCHECK(result);
+
+    result = system->setOutput(FMOD_OUTPUTTYPE_NOSOUND);
+    ERRCHECK(result);
+
+    result = system->init(32, FMOD_INIT_NORMAL, extradriverdata);
+    ERRCHECK(result);
+
+    fbresult = FSBank_Init(FSBANK_FSBVERSION_FSB5, FSBANK_INIT_NORMAL, 2, Common_WritePath("fsbank_cache"));
+    FBCHECK(fbresult);
+
+    memset(assets, 0, sizeof(assets));
+    numassets = loadStats(assets);
+    computeTotals(assets, numassets, &totals);     /* Nothing is planned yet, and never will be with an empty stats file */
+
+    /*
+        Main loop
+    */
+    do
+    {
+        Common_Update();
+
+        /*
+            Measure one asset and format per frame so progress can be drawn
+        */
+        if (measured < numassets * PLAN_FORMAT_COUNT)
+        {
+            Asset *a = &assets[measured / PLAN_FORMAT_COUNT];
+
+            measureAsset(system, a, measured % PLAN_FORMAT_COUNT);
+            measured++;
+
+            if (measured % PLAN_FORMAT_COUNT == 0)
+            {
+                a->averageVoices = Common_Min(a->playsPerMinute / 60.0f * a->lengthSeconds, (float)a->maxVoices);
+            }
+            if (measured == numassets * PLAN_FORMAT_COUNT)
+            {
+                plan(assets, numassets, cpuBudget, memoryBudget, &totals);
+            }
+        }
+        else
+        {
+            bool replan = false;
+
+            if (Common_BtnPress(BTN_UP))
+            {
+                cpuBudget *= 1.25f;
+                replan = true;
+            }
+            if (Common_BtnPress(BTN_DOWN))
+            {
+                cpuBudget = Common_Max(cpuBudget / 1.25f, 0.01f);
+                replan = true;
+            }
+            if (Common_BtnPress(BTN_RIGHT))
+            {
+                memoryBudget += 256 * 1024;
+                replan = true;
+            }
+            if (Common_BtnPress(BTN_LEFT))
+            {
+                memoryBudget = Common_Max(memoryBudget - 256 * 1024, 0);
+                replan = true;
+            }
+            if (replan)
+            {
+                plan(assets, numassets, cpuBudget, memoryBudget, &totals);
+                built = -1;
+            }
+
+            if (Common_BtnPress(BTN_ACTION1))
+            {
+                built = buildBanks(assets, numassets);
+                writeReport(assets, numassets, cpuBudget, memoryBudget, &totals);
+            }
+        }
+
+        Common_Draw("==================================================");
+        Common_Draw("FSBank Format Planner Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2004-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("");
+
+        if (measured < numassets * PLAN_FORMAT_COUNT)
+        {
+            Common_Draw("Measuring %s as %s", assets[measured / PLAN_FORMAT_COUNT].name, gFormats[measured % PLAN_FORMAT_COUNT].name);
+            Common_Draw("%d of %d", measured + 1, numassets * PLAN_FORMAT_COUNT);
+        }
+        else
+        {
+            Common_Draw("Press %s to build banks and report", Common_BtnStr(BTN_ACTION1));
+            Common_Draw("Press %s or %s to change the CPU budget", Common_BtnStr(BTN_UP), Common_BtnStr(BTN_DOWN));
+            Common_Draw("Press %s or %s to change the memory budget", Common_BtnStr(BTN_LEFT), Common_BtnStr(BTN_RIGHT));
+            Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+            Common_Draw("");
+            Common_Draw("Budget    : %6.2f%% CPU %8d KB", cpuBudget, memoryBudget / 1024);
+            Common_Draw("Projected : %6.2f%% CPU %8d KB%s", totals.cpu, totals.memory / 1024,
+                totals.cpu > cpuBudget ? " (CPU over)" : totals.memory > memoryBudget ? " (mem over)" : "");
+            Common_Draw("Peak CPU  : %6.2f%%", totals.peakCpu);
+            Common_Draw("Banks     : PCM %d FADPCM %d Vorbis %d Opus %d", totals.assets[PLAN_PCM], totals.assets[PLAN_FADPCM], totals.assets[PLAN_VORBIS], totals.assets[PLAN_OPUS]);
+            Common_Draw("");
+            Common_Draw("Asset          Format  Voices    CPU   Memory");
+
+            for (int i = 0; i < numassets && i < PLANNER_LIST_LINES; i++)
+            {
+                const Asset *a = &assets[i];
+                if (a->chosen < 0)
+                {
+                    Common_Draw("%-14.14s (no format could encode it)", a->name);
+                    continue;
+                }
+                Common_Draw("%-14.14s %-6s %7.2f %5.2f%% %5d KB", a->name, gFormats[a->chosen].name, a->averageVoices, assetCpu(a, a->chosen), assetMemory(a, a->chosen) / 1024);
+            }
+            if (numassets > PLANNER_LIST_LINES)
+            {
+                Common_Draw("... %d more in %s", numassets - PLANNER_LIST_LINES, PLANNER_REPORT_NAME);
+            }
+
+            if (built >= 0)
+            {
+                Common_Draw("");
+                Common_Draw("Wrote %d banks and %s", built, PLANNER_REPORT_NAME);
+            }
+        }
+
+        Common_Sleep(50);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    /*
+        Shut down
+    */
+    fbresult = FSBank_Release();
+    FBCHECK(fbresult);
+    result = system->close();
+    ERRCHECK(result);
+    result = system->release();
+    ERRCHECK(result);
+
+    Common_Close();
+
+    return 0;
+}
@@ -0,0 +1,518 @@
+/*==============================================================================
+DSP / Stream Buffer Tuner Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how to pick System::setDSPBufferSize and
+System::setStreamBufferSize values from measurements instead of by hand.
+
+A short scripted scenario (a looping sample, one-shots fired at a fixed rate
+and two streams read through a throttled file system) is run once per
+candidate configuration. For each run the example counts mixer deadline
+misses, stream starvation and average DSP / stream CPU. The smallest latency
+configuration with no misses and no starvation is recommended and written to
+a profile file that can be loaded at startup.
+
+By default the timer driven 'no sound' output is used so the results do not
+depend on the audio device, change TUNER_OUTPUTTYPE to tune against the real
+device.
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod.hpp"
+#include "common.h"
+#include <atomic>
+
+#define TUNER_OUTPUTTYPE            FMOD_OUTPUTTYPE_NOSOUND
+#define TUNER_TRIAL_MS              4000        /* Length of one scenario run */
+#define TUNER_ONESHOT_INTERVAL_MS   100         /* How often the scenario fires a one-shot */
+#define TUNER_READ_LATENCY_MS       15          /* Simulated storage latency per stream read */
+#define TUNER_READ_CHUNK            (16 * 1024) /* Simulated storage only hands back this much per read */
+#define TUNER_PROFILE_NAME          "buffer_profile.txt"
+
+struct DSPBufferConfig
+{
+    unsigned int bufferlength;
+    int          numbuffers;
+};
+
+/*
+    Candidates, ordered from lowest to highest latency within each buffer length.
+*/
+static const DSPBufferConfig gDSPConfigs[] =
+{
+    { 256,  2 }, { 256,  3 }, { 256,  4 },
+    { 512,  2 }, { 512,  3 }, { 512,  4 },
+    { 1024, 2 }, { 1024, 3 }, { 1024, 4 },
+};
+static const int NUM_DSP_CONFIGS = sizeof(gDSPConfigs) / sizeof(gDSPConfigs[0]);
+
+static const unsigned int gStreamBufferSizes[] = { 8 * 1024, 16 * 1024, 32 * 1024, 64 * 1024 };
+static const int NUM_STREAM_CONFIGS = sizeof(gStreamBufferSizes) / sizeof(gStreamBufferSizes[0]);
+
+struct TrialResult
+{
+    bool         done;
+    float        latencyms;
+    int          deadlinemisses;
+    float        maxlatenessms;
+    int          starvedupdates;
+    float        dspcpu;
+    float        streamcpu;
+};
+
+/*
+    Mixer timing. The configuration is set by the main thread before the timing DSP is attached, the block
+    clock is only used by the mixer thread and the results are written by the mixer and read by the main thread.
+*/
+struct MixTiming
+{
+    unsigned int  period_us;        /* Duration of one DSP block */
+    unsigned int  slack_us;         /* How late a block can be before the output ring runs dry */
+    unsigned int  base_us;
+    unsigned int  blocks;
+    bool          started;
+    std::atomic<int>          misses;
+    std::atomic<unsigned int> maxlateness_us;
+};
+
+static MixTiming gTiming;
+
+FMOD_RESULT F_CALL timingDSPCallback(FMOD_DSP_STATE * /*dsp_state*/, float *inbuffer, float *outbuffer, unsigned int length, int inchannels, int * /*outchannels*/)
+{
+    unsigned int now;
+    Common_Time_GetUs(&now);
+
+    if (!gTiming.started)
+    {
+        gTiming.base_us = now;
+        gTiming.blocks = 0;
+        gTiming.started = true;
+    }
+    else
+    {
+        /*
+            Block n is due at base + n * period. Anything later than that eats into the buffers queued
+            ahead of the output, once it is later than all of them the output has underrun.
+        */
+        unsigned int due = gTiming.base_us + gTiming.blocks * gTiming.period_us;
+        int lateness = (int)(now - due);
+
+        if (lateness > 0 && (unsigned int)lateness > gTiming.maxlateness_us.load(std::memory_order_relaxed))
+        {
+            gTiming.maxlateness_us.store(lateness, std::memory_order_relaxed);
+        }
+        if (lateness > (int)gTiming.slack_us)
+        {
+            gTiming.misses.fetch_add(1, std::memory_order_relaxed);
+            gTiming.base_us = now;      /* The device would restart from here after the glitch */
+            gTiming.blocks = 0;
+        }
+    }
+    gTiming.blocks++;
+
+    memcpy(outbuffer, inbuffer, length * inchannels * sizeof(float));
+    return FMOD_OK;
+}
+
+/*
+    Stream file callbacks, slowed down to behave like busy storage.
+*/
+FMOD_RESULT F_CALL tunerOpen(const char *name, unsigned int *filesize, void **handle, void * /*userdata*/)
+{
+    Common_File_Open(name, 0, filesize, handle);
+    if (!*handle)
+    {
+        return FMOD_ERR_FILE_NOTFOUND;
+    }
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL tunerClose(void *handle, void * /*userdata*/)
+{
+    Common_File_Close(handle);
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL tunerRead(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread, void * /*userdata*/)
+{
+    unsigned int total = 0;
+
+    while (total < sizebytes)
+    {
+        unsigned int chunk = Common_Min(sizebytes - total, (unsigned int)TUNER_READ_CHUNK);
+        unsigned int read = 0;
+
+        Common_Sleep(TUNER_READ_LATENCY_MS);
+        Common_File_Read(handle, (char *)buffer + total, chunk, &read);
+
+        total += read;
+        if (read < chunk)
+        {
+            break;
+        }
+    }
+
+    *bytesread = total;
+    return (total < sizebytes) ? FMOD_ERR_FILE_EOF : FMOD_OK;
+}
+
+FMOD_RESULT F_CALL tunerSeek(void *handle, unsigned int pos, void * /*userdata*/)
+{
+    Common_File_Seek(handle, pos);
+    return FMOD_OK;
+}
+
+/*
+    One run of the scripted scenario with a given buffer configuration.
+*/
+struct Trial
+{
+    FMOD::System   *system;
+    FMOD::ChannelGroup *master;
+    FMOD::DSP      *timingdsp;
+    FMOD::Sound    *loop;
+    FMOD::Sound    *oneshot[2];
+    FMOD::Sound    *stream[2];
+    unsigned int    start_us;
+    unsigned int    lastshot_us;
+    int             shotindex;
+    int             updates;
+    float           dspcpu;
+    float           streamcpu;
+    int             starved;
+};
+
+static void Trial_Start(Trial *trial, const DSPBufferConfig &dspconfig, unsigned int streambuffersize, void *extradriverdata, float *latencyms)
+{
+    FMOD_RESULT result;
+    int         samplerate = 0;
+
+    memset(trial, 0, sizeof(Trial));
+
+    result = FMOD::System_Create(&trial->system);
+    ERRCHECK(result);
+
+    result = trial->system->setOutput(TUNER_OUTPUTTYPE);
+    ERRCHECK(result);
+
+    result = trial->system->setDSPBufferSize(dspconfig.bufferlength, dspconfig.numbuffers);
+    ERRCHECK(result);
+
+    result = trial->system->init(64, FMOD_INIT_NORMAL, extradriverdata);
+    ERRCHECK(result);
+
+    result = trial->system->setStreamBufferSize(streambuffersize, FMOD_TIMEUNIT_RAWBYTES);
+    ERRCHECK(result);
+
+    result = trial->system->getSoftwareFormat(&samplerate, 0, 0);
+    ERRCHECK(result);
+
+    *latencyms = (float)(dspconfig.bufferlength * dspconfig.numbuffers) * 1000.0f / (float)samplerate;
+
+    /*
+        Load the scenario
+    */
+    result = trial->system->createSound(Common_MediaPath("drumloop.wav"), FMOD_LOOP_NORMAL, 0, &trial->loop);
+    ERRCHECK(result);
+    result = trial->system->createSound(Common_MediaPath("swish.wav"), FMOD_DEFAULT, 0, &trial->oneshot[0]);
+    ERRCHECK(result);
+    result = trial->system->createSound(Common_MediaPath("jaguar.wav"), FMOD_DEFAULT, 0, &trial->oneshot[1]);
+    ERRCHECK(result);
+
+    FMOD_CREATESOUNDEXINFO exinfo;
+    memset(&exinfo, 0, sizeof(FMOD_CREATESOUNDEXINFO));
+    exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+    exinfo.fileuseropen = tunerOpen;
+    exinfo.fileuserclose = tunerClose;
+    exinfo.fileuserread = tunerRead;
+    exinfo.fileuserseek = tunerSeek;
+
+    result = trial->system->createStream(Common_MediaPath("wave.mp3"), FMOD_LOOP_NORMAL | FMOD_IGNORETAGS, &exinfo, &trial->stream[0]);
+    ERRCHECK(result);
+    result = trial->system->createStream(Common_MediaPath("stereo.ogg"), FMOD_LOOP_NORMAL | FMOD_IGNORETAGS, &exinfo, &trial->stream[1]);
+    ERRCHECK(result);
+
+    /*
+        Timing DSP on the master group, so it runs exactly once per mix
+    */
+    {
+        FMOD_DSP_DESCRIPTION dspdesc;
+        memset(&dspdesc, 0, sizeof(dspdesc));
+        strncpy(dspdesc.name, "Mix Timing", sizeof(dspdesc.name));
+        dspdesc.version = 0x00010000;
+        dspdesc.numinputbuffers = 1;
+        dspdesc.numoutputbuffers = 1;
+        dspdesc.read = timingDSPCallback;
+
+        result = trial->system->createDSP(&dspdesc, &trial->timingdsp);
+        ERRCHECK(result);
+    }
+
+    gTiming.base_us = 0;
+    gTiming.blocks = 0;
+    gTiming.started = false;
+    gTiming.misses = 0;
+    gTiming.maxlateness_us = 0;
+    gTiming.period_us = (unsigned int)((unsigned long long)dspconfig.bufferlength * 1000000 / samplerate);
+    gTiming.slack_us = gTiming.period_us * (dspconfig.numbuffers - 1);
+
+    result = trial->system->getMasterChannelGroup(&trial->master);
+    ERRCHECK(result);
+    result = trial->master->addDSP(0, trial->timingdsp);
+    ERRCHECK(result);
+
+    result = trial->system->playSound(trial->loop, 0, false, 0);
+    ERRCHECK(result);
+    result = trial->system->playSound(trial->stream[0], 0, false, 0);
+    ERRCHECK(result);
+    result = trial->system->playSound(trial->stream[1], 0, false, 0);
+    ERRCHECK(result);
+
+    Common_Time_GetUs(&trial->start_us);
+    trial->lastshot_us = trial->start_us;
+}
+
+/*
+    Returns true once the run has finished.
+*/
+static bool Trial_Update(Trial *trial)
+{
+    FMOD_RESULT     result;
+    FMOD_CPU_USAGE  usage;
+    unsigned int    now;
+
+    Common_Time_GetUs(&now);
+
+    if (now - trial->lastshot_us >= TUNER_ONESHOT_INTERVAL_MS * 1000)
+    {
+        result = trial->system->playSound(trial->oneshot[trial->shotindex & 1], 0, false, 0);
+        ERRCHECK(result);
+
+        trial->shotindex++;
+        trial->lastshot_us = now;
+    }
+
+    result = trial->system->update();
+    ERRCHECK(result);
+
+    for (int i = 0; i < 2; i++)
+    {
+        bool starving = false;
+
+        result = trial->stream[i]->getOpenState(0, 0, &starving, 0);
+        ERRCHECK(result);
+
+        if (starving)
+        {
+            trial->starved++;
+        }
+    }
+
+    result = trial->system->getCPUUsage(&usage);
+    ERRCHECK(result);
+
+    trial->dspcpu += usage.dsp;
+    trial->streamcpu += usage.stream;
+    trial->updates++;
+
+    return (now - trial->start_us) >= TUNER_TRIAL_MS * 1000;
+}
+
+static void Trial_Finish(Trial *trial, TrialResult *out)
+{
+    FMOD_RESULT result;
+
+    out->done = true;
+    out->deadlinemisses = gTiming.misses.load();
+    out->maxlatenessms = gTiming.maxlateness_us.load() / 1000.0f;
+    out->starvedupdates = trial->starved;
+    out->dspcpu = trial->updates ? trial->dspcpu / trial->updates : 0.0f;
+    out->streamcpu = trial->updates ? trial->streamcpu / trial->updates : 0.0f;
+
+    for (int i = 0; i < 2; i++)
+    {
+        result = trial->stream[i]->release();
+        ERRCHECK(result);
+        result = trial->oneshot[i]->release();
+        ERRCHECK(result);
+    }
+    result = trial->loop->release();
+    ERRCHECK(result);
+    result = trial->master->removeDSP(trial->timingdsp);
+    ERRCHECK(result);
+    result = trial->timingdsp->release();
+    ERRCHECK(result);
+    result = trial->system->close();
+    ERRCHECK(result);
+    result = trial->system->release();
+    ERRCHECK(result);
+}
+
+static void WriteProfile(const DSPBufferConfig &dspconfig, unsigned int streambuffersize, const TrialResult &dspresult, const TrialResult &streamresult)
+{
+    FILE *file = fopen(Common_WritePath(TUNER_PROFILE_NAME), "w");
+    if (!file)
+    {
+        return;
+    }
+
+    fprintf(file, "; Generated by the FMOD buffer tuner example\n");
+    fprintf(file, "; Apply with System::setDSPBufferSize before System::init and System::setStreamBufferSize before creating streams\n");
+    fprintf(file, "[buffers]\n");
+    fprintf(file, "dspbufferlength = %u\n", dspconfig.bufferlength);
+    fprintf(file, "dspnumbuffers = %d\n", dspconfig.numbuffers);
+    fprintf(file, "streambuffersize = %u\n", streambuffersize);
+    fprintf(file, "streambuffersizetype = FMOD_TIMEUNIT_RAWBYTES\n");
+    fprintf(file, "\n[measured]\n");
+    fprintf(file, "latencyms = %.1f\n", dspresult.latencyms);
+    fprintf(file, "maxlatenessms = %.1f\n", dspresult.maxlatenessms);
+    fprintf(file, "dspcpu = %.1f\n", dspresult.dspcpu);
+    fprintf(file, "streamcpu = %.1f\n", streamresult.streamcpu);
+
+    fclose(file);
+}
+
+int FMOD_Main()
+{
+    TrialResult     dspresults[NUM_DSP_CONFIGS];
+    TrialResult     streamresults[NUM_STREAM_CONFIGS];
+    Trial           trial;
+    bool            running = false;
+    int             dspindex = 0;
+    int             streamindex = 0;
+    int             bestdsp = -1;
+    int             beststream = -1;
+    bool            finished = false;
+    void           *extradriverdata = 0;
+
+    Common_Init(&extradriverdata);
+
+    memset(dspresults, 0, sizeof(dspresults));
+    memset(streamresults, 0, sizeof(streamresults));
+
+    /*
+        Main loop
+    */
+    do
+    {
+        Common_Update();
+
+        if (!finished)
+        {
+            bool sweepingdsp = (dspindex < NUM_DSP_CONFIGS);
+
+            /*
+                First sweep the DSP buffer configurations with a generous stream buffer, then sweep the
+                stream buffer size using the chosen DSP configuration.
+            */
+            if (!running)
+            {
+                if (sweepingdsp)
+                {
+                    Trial_Start(&trial, gDSPConfigs[dspindex], gStreamBufferSizes[NUM_STREAM_CONFIGS - 1], extradriverdata, &dspresults[dspindex].latencyms);
+                }
+                else
+                {
+                    Trial_Start(&trial, gDSPConfigs[bestdsp], gStreamBufferSizes[streamindex], extradriverdata, &streamresults[streamindex].latencyms);
+                }
+                running = true;
+            }
+            else if (Trial_Update(&trial))
+            {
+                running = false;
+
+                if (sweepingdsp)
+                {
+                    Trial_Finish(&trial, &dspresults[dspindex]);
+
+                    /* Keep the smallest latency configuration that never missed a deadline */
+                    if (dspresults[dspindex].deadlinemisses == 0 && (bestdsp < 0 || dspresults[dspindex].latencyms < dspresults[bestdsp].latencyms))
+                    {
+                        bestdsp = dspindex;
+                    }
+
+                    dspindex++;
+                    if (dspindex == NUM_DSP_CONFIGS && bestdsp < 0)
+                    {
+                        bestdsp = NUM_DSP_CONFIGS - 1;  /* Nothing was clean, fall back to the safest candidate */
+                    }
+                }
+                else
+                {
+                    Trial_Finish(&trial, &streamresults[streamindex]);
+
+                    if (streamresults[streamindex].starvedupdates == 0 && beststream < 0)
+                    {
+                        beststream = streamindex;
+                    }
+
+                    streamindex++;
+                    if (streamindex == NUM_STREAM_CONFIGS)
+                    {
+                        if (beststream < 0)
+                        {
+                            beststream = NUM_STREAM_CONFIGS - 1;
+                        }
+
+                        WriteProfile(gDSPConfigs[bestdsp], gStreamBufferSizes[beststream], dspresults[bestdsp], streamresults[beststream]);
+                        finished = true;
+                    }
+                }
+            }
+        }
+
+        Common_Draw("==================================================");
+        Common_Draw("Buffer Tuner Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2004-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("Buffer   Num  Latency Miss  Late   DSP%%");
+        for (int i = 0; i < NUM_DSP_CONFIGS; i++)
+        {
+            const TrialResult &r = dspresults[i];
+            if (r.done)
+            {
+                Common_Draw("%5u %5d %7.1fms %4d %5.1fms %5.1f%s", gDSPConfigs[i].bufferlength, gDSPConfigs[i].numbuffers, r.latencyms, r.deadlinemisses, r.maxlatenessms, r.dspcpu, (finished && i == bestdsp) ? " <" : "");
+            }
+            else
+            {
+                Common_Draw("%5u %5d %s", gDSPConfigs[i].bufferlength, gDSPConfigs[i].numbuffers, (running && i == dspindex) ? "running..." : "");
+            }
+        }
+        Common_Draw("Stream buffer   Starved  Stream%%");
+        for (int i = 0; i < NUM_STREAM_CONFIGS; i++)
+        {
+            const TrialResult &r = streamresults[i];
+            if (r.done)
+            {
+                Common_Draw("%10u %12d %8.1f%s", gStreamBufferSizes[i], r.starvedupdates, r.streamcpu, (finished && i == beststream) ? " <" : "");
+            }
+            else
+            {
+                Common_Draw("%10u %s", gStreamBufferSizes[i], (running && dspindex == NUM_DSP_CONFIGS && i == streamindex) ? "running..." : "");
+            }
+        }
+        Common_Draw("");
+        if (finished)
+        {
+            Common_Draw("Recommended %u x %d, stream %u bytes", gDSPConfigs[bestdsp].bufferlength, gDSPConfigs[bestdsp].numbuffers, gStreamBufferSizes[beststream]);
+            Common_Draw("Profile written to %s", TUNER_PROFILE_NAME);
+        }
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+
+        Common_Sleep(10);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    /*
+        Shut down
+    */
+    if (running)
+    {
+        TrialResult discard;
+        Trial_Finish(&trial, &discard);
+    }
+
+    Common_Close();
+
+    return 0;
+}
@@ -0,0 +1,348 @@
+/*==============================================================================
+Chain Fusion Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how much mixer time is saved by running a per voice
+effect chain inside one DSP node instead of one node per effect.
+
+Every voice runs gain -> distance filter -> gain. In 'separate' mode each
+effect is its own DSP on the channel, in 'fused' mode the three effects are
+hosted by a single fmod_chain DSP (plugins/fmod_chain.cpp) that runs them
+back to back on one block. The DSP graph node count and the mixer DSP CPU
+are averaged separately for both modes.
+
+The plug-ins are loaded from fmod_gain.dll, fmod_distance_filter.dll and
+fmod_chain.dll, build those projects first.
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod.hpp"
+#include "common.h"
+#include "plugins/fmod_chain.h"
+
+const char *GAIN_FILENAME           = "fmod_gain" COMMON_PLUGIN_SUFFIX ".dll";
+const char *FILTER_FILENAME         = "fmod_distance_filter" COMMON_PLUGIN_SUFFIX ".dll";
+const char *CHAIN_FILENAME          = "fmod_chain" COMMON_PLUGIN_SUFFIX ".dll";
+const int   NUM_VOICES              = 64;
+const int   NUM_EFFECTS             = 3;    /* gain -> distance filter -> gain */
+const int   PARAM_GAIN              = 0;    /* Parameter index from fmod_gain.cpp */
+const int   PARAM_3D_ATTRIBUTES     = 2;    /* Parameter index from fmod_distance_filter.cpp */
+const float AVERAGE_WEIGHT          = 0.05f;
+
+struct Voice
+{
+    FMOD::Channel  *channel;
+    FMOD::DSP      *effect[NUM_EFFECTS];    /* Separate mode */
+    FMOD::DSP      *chain;                  /* Fused mode */
+};
+
+/*
+    Set a float parameter on effect 'slot', either directly or through the chain's forward parameter
+*/
+FMOD_RESULT setEffectFloat(Voice *voice, bool fused, int slot, int index, float value)
+{
+    if (!fused)
+    {
+        return voice->effect[slot]->setParameterFloat(index, value);
+    }
+
+    FMOD_CHAIN_PARAMETER param;
+    memset(&param, 0, sizeof(param));
+    param.slot = slot;
+    param.index = index;
+    param.type = FMOD_DSP_PARAMETER_TYPE_FLOAT;
+    param.floatvalue = value;
+    return voice->chain->setParameterData(FMOD_CHAIN_PARAM_FORWARD, &param, sizeof(param));
+}
+
+FMOD_RESULT setEffectData(Voice *voice, bool fused, int slot, int index, void *data, unsigned int length)
+{
+    if (!fused)
+    {
+        return voice->effect[slot]->setParameterData(index, data, length);
+    }
+
+    FMOD_CHAIN_PARAMETER param;
+    memset(&param, 0, sizeof(param));
+    param.slot = slot;
+    param.index = index;
+    param.type = FMOD_DSP_PARAMETER_TYPE_DATA;
+    param.data = data;
+    param.datalength = length;
+    return voice->chain->setParameterData(FMOD_CHAIN_PARAM_FORWARD, &param, sizeof(param));
+}
+
+/*
+    Swap the DSPs on every channel from one node per effect to a single chain node, or back
+*/
+void attachEffects(Voice *voices, bool fused)
+{
+    FMOD_RESULT result;
+
+    for (int i = 0; i < NUM_VOICES; i++)
+    {
+        Voice *voice = &voices[i];
+
+        for (int j = 0; j < NUM_EFFECTS; j++)
+        {
+            result = fused ? voice->channel->removeDSP(voice->effect[j]) : voice->channel->addDSP(j, voice->effect[j]);
+            ERRCHECK(result);
+        }
+
+        result = fused ? voice->channel->addDSP(0, voice->chain) : voice->channel->removeDSP(voice->chain);
+        ERRCHECK(result);
+    }
+}
+
+int FMOD_Main()
+{
+    FMOD::System       *system;
+    FMOD::Sound        *sound;
+    Voice               voices[NUM_VOICES];
+    FMOD_RESULT         result;
+    unsigned int        gainhandle, filterhandle, chainhandle;
+    FMOD_CHAIN_SLOTS    slots;
+    bool                fused = false;
+    float               radius = 20.0f;
+    float               average_cpu[2] = { 0.0f, 0.0f };    /* [0] = separate, [1] = fused */
+    float               average_us[2] = { 0.0f, 0.0f };
+    void               *extradriverdata = 0;
+
+    Common_Init(&extradriverdata);
+
+    /*
+        Create a System object and initialize. Profiling is enabled so DSP::getCPUUsage reports per unit times.
+    */
+    result = FMOD::System_Create(&system);
+    ERRCHECK(result);
+
+    result = system->setSoftwareChannels(NUM_VOICES);
+    ERRCHECK(result);
+
+    result = system->init(NUM_VOICES, FMOD_INIT_PROFILE_ENABLE, extradriverdata);
+    ERRCHECK(result);
+
+    result = system->loadPlugin(GAIN_FILENAME, &gainhandle);
+    ERRCHECK(result);
+    result = system->loadPlugin(FILTER_FILENAME, &filterhandle);
+    ERRCHECK(result);
+    result = system->loadPlugin(CHAIN_FILENAME, &chainhandle);
+    ERRCHECK(result);
+
+    /*
+        The chain hosts the same descriptions FMOD uses for the separate nodes
+    */
+    memset(&slots, 0, sizeof(slots));
+    slots.numslots = NUM_EFFECTS;
+    result = system->getDSPInfoByPlugin(gainhandle, &slots.description[0]);
+    ERRCHECK(result);
+    result = system->getDSPInfoByPlugin(filterhandle, &slots.description[1]);
+    ERRCHECK(result);
+    slots.description[2] = slots.description[0];
+
+    result = system->createSound(Common_MediaPath("drumloop.wav"), FMOD_3D | FMOD_LOOP_NORMAL, 0, &sound);
+    ERRCHECK(result);
+
+    for (int i = 0; i < NUM_VOICES; i++)
+    {
+        Voice *voice = &voices[i];
+
+        result = system->playSound(sound, 0, true, &voice->channel);
+        ERRCHECK(result);
+
+        result = system->createDSPByPlugin(gainhandle, &voice->effect[0]);
+        ERRCHECK(result);
+        result = system->createDSPByPlugin(filterhandle, &voice->effect[1]);
+        ERRCHECK(result);
+        result = system->createDSPByPlugin(gainhandle, &voice->effect[2]);
+        ERRCHECK(result);
+
+        /* Slots are set before connecting so the first mix already runs them */
+        result = system->createDSPByPlugin(chainhandle, &voice->chain);
+        ERRCHECK(result);
+        result = voice->chain->setParameterData(FMOD_CHAIN_PARAM_SLOTS, &slots, sizeof(slots));
+        ERRCHECK(result);
+
+        for (int j = 0; j < 2; j++)
+        {
+            result = setEffectFloat(voice, j == 1, 0, PARAM_GAIN, -3.0f);
+            ERRCHECK(result);
+            result = setEffectFloat(voice, j == 1, 2, PARAM_GAIN, -3.0f);
+            ERRCHECK(result);
+        }
+
+        result = voice->channel->setVolume(1.0f / NUM_VOICES);
+        ERRCHECK(result);
+    }
+
+    for (int i = 0; i < NUM_VOICES; i++)
+    {
+        for (int j = 0; j < NUM_EFFECTS; j++)
+        {
+            result = voices[i].channel->addDSP(j, voices[i].effect[j]);
+            ERRCHECK(result);
+        }
+
+        result = voices[i].channel->setPaused(false);
+        ERRCHECK(result);
+    }
+
+    /*
+        Main loop
+    */
+    do
+    {
+        Common_Update();
+
+        if (Common_BtnPress(BTN_ACTION1))
+        {
+            fused = !fused;
+            attachEffects(voices, fused);
+        }
+        if (Common_BtnDown(BTN_UP))
+        {
+            radius = Common_Min(radius + 0.5f, 100.0f);
+        }
+        if (Common_BtnDown(BTN_DOWN))
+        {
+            radius = Common_Max(radius - 0.5f, 1.0f);
+        }
+
+        /*
+            Position the voices and feed the distance filter its relative position, through the chain when fused
+        */
+        for (int i = 0; i < NUM_VOICES; i++)
+        {
+            float angle = (float)i * 6.2831853f / NUM_VOICES;
+            FMOD_VECTOR position = { Common_Sin(angle) * radius, 0.0f, Common_Sin(angle + 1.5707963f) * radius };
+            FMOD_VECTOR velocity = { 0.0f, 0.0f, 0.0f };
+            FMOD_DSP_PARAMETER_3DATTRIBUTES attributes;
+
+            result = voices[i].channel->set3DAttributes(&position, &velocity);
+            ERRCHECK(result);
+
+            memset(&attributes, 0, sizeof(attributes));
+            attributes.relative.position = position;
+            attributes.relative.forward.z = 1.0f;
+            attributes.relative.up.y = 1.0f;
+            attributes.absolute = attributes.relative;
+
+            result = setEffectData(&voices[i], fused, 1, PARAM_3D_ATTRIBUTES, &attributes, sizeof(attributes));
+            ERRCHECK(result);
+        }
+
+        result = system->update();
+        ERRCHECK(result);
+
+        /*
+            Count the nodes on the channels and sum the exclusive time of the effect DSPs
+        */
+        int numnodes = 0;
+        {
+            unsigned int total_us = 0;
+            FMOD_CPU_USAGE usage;
+
+            for (int i = 0; i < NUM_VOICES; i++)
+            {
+                int numdsps = 0;
+                unsigned int exclusive = 0;
+
+                result = voices[i].channel->getNumDSPs(&numdsps);
+                ERRCHECK(result);
+                numnodes += numdsps;
+
+                if (fused)
+                {
+                    result = voices[i].chain->getCPUUsage(&exclusive, 0);
+                    ERRCHECK(result);
+                    total_us += exclusive;
+                }
+                else
+                {
+                    for (int j = 0; j < NUM_EFFECTS; j++)
+                    {
+                        result = voices[i].effect[j]->getCPUUsage(&exclusive, 0);
+                        ERRCHECK(result);
+                        total_us += exclusive;
+                    }
+                }
+            }
+
+            result = system->getCPUUsage(&usage);
+            ERRCHECK(result);
+
+            float &cpu = average_cpu[fused ? 1 : 0];
+            float &us = average_us[fused ? 1 : 0];
+            cpu = (cpu == 0.0f) ? usage.dsp : cpu + AVERAGE_WEIGHT * (usage.dsp - cpu);
+            us = (us == 0.0f) ? (float)total_us : us + AVERAGE_WEIGHT * ((float)total_us - us);
+        }
+
+        Common_Draw("==================================================");
+        Common_Draw("Chain Fusion Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2004-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("");
+        Common_Draw("Press %s to toggle separate / fused effects", Common_BtnStr(BTN_ACTION1));
+        Common_Draw("Hold %s / %s to move voices closer / further", Common_BtnStr(BTN_DOWN), Common_BtnStr(BTN_UP));
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+        Common_Draw("");
+        Common_Draw("Voices           : %d at %.1f", NUM_VOICES, radius);
+        Common_Draw("Mode             : %s", fused ? "Fused" : "Separate");
+        Common_Draw("Channel DSPs     : %d", numnodes);
+        Common_Draw("");
+        Common_Draw("             Mixer CPU   Effect time");
+        Common_Draw("Separate   : %7.1f %%  %8.0f us", average_cpu[0], average_us[0]);
+        Common_Draw("Fused      : %7.1f %%  %8.0f us", average_cpu[1], average_us[1]);
+        if (average_cpu[0] > 0.0f && average_cpu[1] > 0.0f)
+        {
+            Common_Draw("Saved      : %7.1f %%", 100.0f * (1.0f - average_cpu[1] / average_cpu[0]));
+        }
+        else
+        {
+            Common_Draw("Saved      : toggle mode to measure");
+        }
+
+        Common_Sleep(50);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    /*
+        Shut down
+    */
+    for (int i = 0; i < NUM_VOICES; i++)
+    {
+        Voice *voice = &voices[i];
+
+        if (fused)
+        {
+            result = voice->channel->removeDSP(voice->chain);
+            ERRCHECK(result);
+        }
+        else
+        {
+            for (int j = 0; j < NUM_EFFECTS; j++)
+            {
+                result = voice->channel->removeDSP(voice->effect[j]);
+                ERRCHECK(result);
+            }
+        }
+
+        for (int j = 0; j < NUM_EFFECTS; j++)
+        {
+            result = voice->effect[j]->release();
+            ERRCHECK(result);
+        }
+        result = voice->chain->release();
+        ERRCHECK(result);
+    }
+    result = sound->release();
+    ERRCHECK(result);
+    result = system->close();
+    ERRCHECK(result);
+    result = system->release();
+    ERRCHECK(result);
+
+    Common_Close();
+
+    return 0;
+}
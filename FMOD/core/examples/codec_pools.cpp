@@ -0,0 +1,570 @@
+/*==============================================================================
+Codec Pool Advisor Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how to size the decoder pools set by the max*Codecs
+members of FMOD_ADVANCEDSETTINGS from measurements of a running session.
+
+Every sound created with FMOD_CREATECOMPRESSEDSAMPLE needs a codec instance
+from the pool of its format for each real voice playing it. The pools are
+preallocated, so oversized pools waste memory and undersized pools starve
+busy scenes.
+
+A scripted session (explore, combat, cutscene) fires MPEG and Vorbis
+samples. Each frame the playing, non virtual channels of the System are
+counted per codec. At the end the peak and 95th percentile are shown with a
+recommended pool size (peak plus a safety margin), and the pool memory is
+measured by loading the same formats into a scratch System with the default
+and the recommended settings. The recommendation is written to a profile
+file that can be applied with System::setAdvancedSettings before init.
+
+The codec of a sound comes from Sound::getFormat, FSB files report the FSB
+container so their codec is read from the FSB5 header. Counts are sampled
+once per frame so voices shorter than a frame can be missed, leave the
+margin in place for that reason.
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod.hpp"
+#include "common.h"
+
+#define ADVISOR_MAX_VOICES          256
+#define ADVISOR_MARGIN_PERCENT      25          /* Safety margin on top of the recorded peak */
+#define ADVISOR_MARGIN_MIN          2           /* ...but never less than this many extra codecs */
+#define ADVISOR_PROFILE_NAME        "codec_pools.txt"
+
+enum CodecType
+{
+    CODEC_NONE = -1,
+    CODEC_MPEG,
+    CODEC_ADPCM,
+    CODEC_XMA,
+    CODEC_VORBIS,
+    CODEC_AT9,
+    CODEC_FADPCM,
+    CODEC_OPUS,
+    CODEC_COUNT
+};
+
+struct CodecInfo
+{
+    const char                 *name;
+    int FMOD_ADVANCEDSETTINGS::*pool;
+    int                         fsbMode;        /* Codec id in the FSB5 header */
+};
+
+static const CodecInfo gCodecs[CODEC_COUNT] =
+{
+    { "MPEG",   &FMOD_ADVANCEDSETTINGS::maxMPEGCodecs,   11 },
+    { "ADPCM",  &FMOD_ADVANCEDSETTINGS::maxADPCMCodecs,  7  },
+    { "XMA",    &FMOD_ADVANCEDSETTINGS::maxXMACodecs,    10 },
+    { "Vorbis", &FMOD_ADVANCEDSETTINGS::maxVorbisCodecs, 15 },
+    { "AT9",    &FMOD_ADVANCEDSETTINGS::maxAT9Codecs,    13 },
+    { "FADPCM", &FMOD_ADVANCEDSETTINGS::maxFADPCMCodecs, 16 },
+    { "Opus",   &FMOD_ADVANCEDSETTINGS::maxOpusCodecs,   17 },
+};
+
+/*
+    The session script. Rates are voices started per second, lengths are how long each voice is allowed to play.
+*/
+struct SessionPhase
+{
+    const char  *name;
+    int          durationms;
+    float        mpegRate;
+    float        vorbisRate;
+    int          minLengthMs;
+    int          maxLengthMs;
+};
+
+static const SessionPhase gPhases[] =
+{
+    { "Explore",  6000, 0.5f, 1.5f, 1000, 3000 },
+    { "Combat",   6000, 2.0f, 9.0f, 500,  2000 },
+    { "Cutscene", 4000, 1.0f, 0.5f, 2000, 4000 },
+};
+static const int NUM_PHASES = sizeof(gPhases) / sizeof(gPhases[0]);
+
+struct CodecStats
+{
+    int          histogram[ADVISOR_MAX_VOICES + 1];     /* Frames spent at each concurrent voice count */
+    int          frames;
+    int          peak;
+    int          p95;
+    int          recommended;
+    const char  *sampleFile;                            /* Used to measure the pool memory */
+};
+
+struct Voice
+{
+    FMOD::Channel  *channel;
+    unsigned int    stopUs;
+};
+
+/*
+    Deterministic random numbers so every run of the script is the same session
+*/
+static unsigned int gSeed = 1;
+
+float scriptRandom()
+{
+    gSeed = gSeed * 1664525 + 1013904223;
+    return (gSeed >> 8) / 16777216.0f;
+}
+
+CodecType codecFromFSBHeader(const char *filename)
+{
+    unsigned char   header[28];
+    unsigned int    filesize, bytesread = 0;
+    void           *handle;
+
+    Common_File_Open(filename, 0, &filesize, &handle);
+    if (!handle)
+    {
+        return CODEC_NONE;
+    }
+    Common_File_Read(handle, header, sizeof(header), &bytesread);
+    Common_File_Close(handle);
+
+    if (bytesread < sizeof(header) || memcmp(header, "FSB5", 4))
+    {
+        return CODEC_NONE;
+    }
+
+    int mode = header[24] | (header[25] << 8) | (header[26] << 16) | (header[27] << 24);
+    for (int i = 0; i < CODEC_COUNT; i++)
+    {
+        if (gCodecs[i].fsbMode == mode)
+        {
+            return (CodecType)i;
+        }
+    }
+    return CODEC_NONE;  /* PCM */
+}
+
+/*
+    Work out which pool a sound draws from and remember it in the sound's user data, so the per frame scan
+    doesn't have to.
+*/
+CodecType classifySound(FMOD::Sound *sound, const char *filename)
+{
+    FMOD_RESULT         result;
+    FMOD_SOUND_TYPE     type;
+    FMOD_MODE           mode;
+    CodecType           codec = CODEC_NONE;
+
+    result = sound->getMode(&mode);
+    ERRCHECK(result);
+    result = sound->getFormat(&type, 0, 0, 0);
+    ERRCHECK(result);
+
+    if (mode & FMOD_CREATECOMPRESSEDSAMPLE)
+    {
+        switch (type)
+        {
+            case FMOD_SOUND_TYPE_MPEG:   codec = CODEC_MPEG;   break;
+            case FMOD_SOUND_TYPE_XMA:    codec = CODEC_XMA;    break;
+            case FMOD_SOUND_TYPE_VORBIS: codec = CODEC_VORBIS; break;
+            case FMOD_SOUND_TYPE_AT9:    codec = CODEC_AT9;    break;
+            case FMOD_SOUND_TYPE_FADPCM: codec = CODEC_FADPCM; break;
+            case FMOD_SOUND_TYPE_OPUS:   codec = CODEC_OPUS;   break;
+            case FMOD_SOUND_TYPE_FSB:    codec = codecFromFSBHeader(filename); break;
+            default:                                           break;
+        }
+    }
+
+    result = sound->setUserData((void *)(size_t)(codec + 1));
+    ERRCHECK(result);
+    return codec;
+}
+
+/*
+    Count the real voices per codec. Virtual voices don't hold a codec instance.
+*/
+void sampleVoices(FMOD::System *system, CodecStats *stats)
+{
+    FMOD_RESULT result;
+    int         counts[CODEC_COUNT] = { 0 };
+
+    for (int i = 0; i < ADVISOR_MAX_VOICES; i++)
+    {
+        FMOD::Channel  *channel;
+        FMOD::Sound    *sound;
+        bool            playing = false, isvirtual = true;
+        void           *userdata;
+
+        if (system->getChannel(i, &channel) != FMOD_OK)
+        {
+            break;
+        }
+        if (channel->isPlaying(&playing) != FMOD_OK || !playing || channel->isVirtual(&isvirtual) != FMOD_OK || isvirtual)
+        {
+            continue;
+        }
+        if (channel->getCurrentSound(&sound) != FMOD_OK || !sound)
+        {
+            continue;
+        }
+
+        result = sound->getUserData(&userdata);
+        ERRCHECK(result);
+        int codec = (int)(size_t)userdata - 1;
+        if (codec > CODEC_NONE)
+        {
+            counts[codec]++;
+        }
+    }
+
+    for (int i = 0; i < CODEC_COUNT; i++)
+    {
+        stats[i].histogram[counts[i]]++;
+        stats[i].frames++;
+        stats[i].peak = Common_Max(stats[i].peak, counts[i]);
+    }
+}
+
+void computeRecommendations(CodecStats *stats)
+{
+    for (int i = 0; i < CODEC_COUNT; i++)
+    {
+        CodecStats *s = &stats[i];
+        int total = 0;
+
+        s->p95 = 0;
+        for (int n = 0; n <= ADVISOR_MAX_VOICES; n++)
+        {
+            total += s->histogram[n];
+            if (total * 100 >= s->frames * 95)
+            {
+                s->p95 = n;
+                break;
+            }
+        }
+
+        if (s->peak)
+        {
+            int margin = Common_Max(ADVISOR_MARGIN_MIN, (s->peak * ADVISOR_MARGIN_PERCENT + 99) / 100);
+            s->recommended = Common_Min(s->peak + margin, 256);
+        }
+        else
+        {
+            s->recommended = 0;     /* Not used by this session, leave the default */
+        }
+    }
+}
+
+/*
+    Load one compressed sample per recorded codec into a scratch System and play it, which forces the codec
+    pools to be allocated, then report how much memory that took.
+*/
+int measurePoolMemory(CodecStats *stats, FMOD_ADVANCEDSETTINGS *settings)
+{
+    FMOD_RESULT      result;
+    FMOD::System    *system;
+    FMOD::Sound     *sounds[CODEC_COUNT] = { 0 };
+    int              before, after;
+
+    result = FMOD::Memory_GetStats(&before, 0);
+    ERRCHECK(result);
+
+    result = FMOD::System_Create(&system);
+    ERRCHECK(result);
+    result = system->setOutput(FMOD_OUTPUTTYPE_NOSOUND);
+    ERRCHECK(result);
+    result = system->setAdvancedSettings(settings);
+    ERRCHECK(result);
+    result = system->init(32, FMOD_INIT_NORMAL, 0);
+    ERRCHECK(result);
+
+    for (int i = 0; i < CODEC_COUNT; i++)
+    {
+        if (!stats[i].sampleFile)
+        {
+            continue;
+        }
+
+        FMOD::Sound    *sound;
+        FMOD::Channel  *channel;
+        int             numsubsounds;
+
+        result = system->createSound(Common_MediaPath(stats[i].sampleFile), FMOD_CREATECOMPRESSEDSAMPLE, 0, &sounds[i]);
+        ERRCHECK(result);
+
+        sound = sounds[i];
+        result = sound->getNumSubSounds(&numsubsounds);
+        ERRCHECK(result);
+        if (numsubsounds)
+        {
+            result = sound->getSubSound(0, &sound);
+            ERRCHECK(result);
+        }
+
+        result = system->playSound(sound, 0, true, &channel);
+        ERRCHECK(result);
+    }
+
+    result = system->update();
+    ERRCHECK(result);
+
+    result = FMOD::Memory_GetStats(&after, 0);
+    ERRCHECK(result);
+
+    for (int i = 0; i < CODEC_COUNT; i++)
+    {
+        if (sounds[i])
+        {
+            result = sounds[i]->release();
+            ERRCHECK(result);
+        }
+    }
+    result = system->close();
+    ERRCHECK(result);
+    result = system->release();
+    ERRCHECK(result);
+
+    return after - before;
+}
+
+void writeProfile(const CodecStats *stats, int defaultmemory, int advisedmemory)
+{
+    FILE *file = fopen(Common_WritePath(ADVISOR_PROFILE_NAME), "w");
+    if (!file)
+    {
+        return;
+    }
+
+    fprintf(file, "; Generated by the FMOD codec pool advisor example\n");
+    fprintf(file, "; Apply with System::setAdvancedSettings before System::init, 0 leaves the default\n");
+    fprintf(file, "[advancedsettings]\n");
+    for (int i = 0; i < CODEC_COUNT; i++)
+    {
+        fprintf(file, "max%sCodecs = %d\n", gCodecs[i].name, stats[i].recommended);
+    }
+    fprintf(file, "\n[measured]\n");
+    for (int i = 0; i < CODEC_COUNT; i++)
+    {
+        if (stats[i].peak)
+        {
+            fprintf(file, "%s peak = %d, p95 = %d\n", gCodecs[i].name, stats[i].peak, stats[i].p95);
+        }
+    }
+    fprintf(file, "poolbytesdefault = %d\n", defaultmemory);
+    fprintf(file, "poolbytesadvised = %d\n", advisedmemory);
+
+    fclose(file);
+}
+
+int FMOD_Main()
+{
+    FMOD::System           *system;
+    FMOD::Sound            *mpeg, *vorbisBank, *vorbis;
+    FMOD_RESULT             result;
+    FMOD_ADVANCEDSETTINGS   defaults;
+    CodecStats              stats[CODEC_COUNT];
+    Voice                   voices[ADVISOR_MAX_VOICES];
+    int                     numvoices = 0;
+    int                     phase = 0;
+    unsigned int            phaseStartUs;
+    int                     defaultmemory = 0, advisedmemory = 0;
+    bool                    finished = false;
+    void                   *extradriverdata = 0;
+
+    Common_Init(&extradriverdata);
+
+    /*
+        Create a System object and initialize
+    */
+    result = FMOD::System_Create(&system);
+    ERRCHECK(result);
+
+    result = system->init(ADVISOR_MAX_VOICES, FMOD_INIT_NORMAL, extradriverdata);
+    ERRCHECK(result);
+
+    memset(&defaults, 0, sizeof(defaults));
+    defaults.cbSize = sizeof(defaults);
+    result = system->getAdvancedSettings(&defaults);
+    ERRCHECK(result);
+
+    /*
+        The session's content. wave_vorbis.fsb reports the FSB container, its codec comes from the header.
+    */
+    memset(stats, 0, sizeof(stats));
+
+    result = system->createSound(Common_MediaPath("wave.mp3"), FMOD_CREATECOMPRESSEDSAMPLE, 0, &mpeg);
+    ERRCHECK(result);
+    CodecType codec = classifySound(mpeg, Common_MediaPath("wave.mp3"));
+    if (codec > CODEC_NONE)
+    {
+        stats[codec].sampleFile = "wave.mp3";
+    }
+
+    result = system->createSound(Common_MediaPath("wave_vorbis.fsb"), FMOD_CREATECOMPRESSEDSAMPLE, 0, &vorbisBank);
+    ERRCHECK(result);
+    result = vorbisBank->getSubSound(0, &vorbis);
+    ERRCHECK(result);
+    codec = classifySound(vorbis, Common_MediaPath("wave_vorbis.fsb"));
+    if (codec > CODEC_NONE)
+    {
+        stats[codec].sampleFile = "wave_vorbis.fsb";
+    }
+
+    Common_Time_GetUs(&phaseStartUs);
+
+    /*
+        Main loop
+    */
+    do
+    {
+        unsigned int now;
+
+        Common_Update();
+        Common_Time_GetUs(&now);
+
+        if (Common_BtnPress(BTN_ACTION1) && finished)
+        {
+            /* Run the script again */
+            for (int i = 0; i < CODEC_COUNT; i++)
+            {
+                const char *file = stats[i].sampleFile;
+                memset(&stats[i], 0, sizeof(CodecStats));
+                stats[i].sampleFile = file;
+            }
+            gSeed = 1;
+            phase = 0;
+            phaseStartUs = now;
+            finished = false;
+        }
+
+        if (!finished)
+        {
+            const SessionPhase *p = &gPhases[phase];
+            float frameSeconds = 0.05f;
+
+            /*
+                Start voices for this frame
+            */
+            FMOD::Sound *sources[2] = { mpeg, vorbis };
+            float rates[2] = { p->mpegRate, p->vorbisRate };
+            for (int s = 0; s < 2; s++)
+            {
+                if (scriptRandom() < rates[s] * frameSeconds && numvoices < ADVISOR_MAX_VOICES)
+                {
+                    Voice *voice = &voices[numvoices++];
+                    int lengthms = p->minLengthMs + (int)(scriptRandom() * (p->maxLengthMs - p->minLengthMs));
+
+                    result = system->playSound(sources[s], 0, false, &voice->channel);
+                    ERRCHECK(result);
+                    result = voice->channel->setVolume(0.05f);
+                    ERRCHECK(result);
+                    voice->stopUs = now + lengthms * 1000;
+                }
+            }
+
+            if (now - phaseStartUs >= (unsigned int)p->durationms * 1000)
+            {
+                phase++;
+                phaseStartUs = now;
+            }
+        }
+
+        /*
+            Stop voices that have run their length. Stolen channels return an error, which is fine here.
+        */
+        for (int i = 0; i < numvoices; )
+        {
+            if ((int)(now - voices[i].stopUs) >= 0 || finished)
+            {
+                voices[i].channel->stop();
+                voices[i] = voices[--numvoices];
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        result = system->update();
+        ERRCHECK(result);
+
+        if (!finished)
+        {
+            sampleVoices(system, stats);
+
+            if (phase == NUM_PHASES)
+            {
+                finished = true;
+                computeRecommendations(stats);
+
+                FMOD_ADVANCEDSETTINGS advised = defaults;
+                for (int i = 0; i < CODEC_COUNT; i++)
+                {
+                    if (stats[i].recommended)
+                    {
+                        advised.*gCodecs[i].pool = stats[i].recommended;
+                    }
+                }
+
+                defaultmemory = measurePoolMemory(stats, &defaults);
+                advisedmemory = measurePoolMemory(stats, &advised);
+                writeProfile(stats, defaultmemory, advisedmemory);
+            }
+        }
+
+        Common_Draw("==================================================");
+        Common_Draw("Codec Pool Advisor Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2004-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("");
+        if (!finished)
+        {
+            Common_Draw("Recording phase %d/%d: %s", phase + 1, NUM_PHASES, gPhases[Common_Min(phase, NUM_PHASES - 1)].name);
+        }
+        else
+        {
+            Common_Draw("Press %s to record the session again", Common_BtnStr(BTN_ACTION1));
+        }
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+        Common_Draw("");
+        Common_Draw("Codec    Peak   P95  Default  Recommended");
+        for (int i = 0; i < CODEC_COUNT; i++)
+        {
+            int defaultsize = defaults.*gCodecs[i].pool;
+
+            if (finished && stats[i].recommended)
+            {
+                Common_Draw("%-7s %5d %5d %8d %12d", gCodecs[i].name, stats[i].peak, stats[i].p95, defaultsize, stats[i].recommended);
+            }
+            else
+            {
+                Common_Draw("%-7s %5d %5s %8d %12s", gCodecs[i].name, stats[i].peak, "-", defaultsize, finished ? "default" : "-");
+            }
+        }
+        Common_Draw("");
+        if (finished)
+        {
+            Common_Draw("Pool memory, default  : %7d KB", defaultmemory / 1024);
+            Common_Draw("Pool memory, advised  : %7d KB", advisedmemory / 1024);
+            Common_Draw("Saved                 : %7d KB", (defaultmemory - advisedmemory) / 1024);
+            Common_Draw("Profile written to %s", ADVISOR_PROFILE_NAME);
+        }
+
+        Common_Sleep(50);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    /*
+        Shut down
+    */
+    result = mpeg->release();
+    ERRCHECK(result);
+    result = vorbisBank->release();
+    ERRCHECK(result);
+    result = system->close();
+    ERRCHECK(result);
+    result = system->release();
+    ERRCHECK(result);
+
+    Common_Close();
+
+    return 0;
+}
@@ -225,7 +225,13 @@ void Common_Mutex_Leave(Common_Mutex *mutex)
 
 void Common_Thread_Create(void (*callback)(void *param), void *param, void **handle)
 {
-    FMOD_OS_Thread_Create("FMOD Example Thread", callback, param, FMOD_THREAD_AFFINITY_GROUP_A, FMOD_THREAD_PRIORITY_MEDIUM, (16 * 1024), handle);
+    Common_Thread_Create(callback, param, FMOD_THREAD_AFFINITY_GROUP_A, FMOD_THREAD_PRIORITY_MEDIUM, (16 * 1024), handle);
+}
+
+void Common_Thread_Create(void (*callback)(void *param), void *param, FMOD_THREAD_AFFINITY affinity, FMOD_THREAD_PRIORITY priority, FMOD_THREAD_STACK_SIZE stacksize, void **handle)
+{
+    FMOD_RESULT result = FMOD_OS_Thread_Create("FMOD Example Thread", callback, param, affinity, priority, stacksize, handle);
+    ERRCHECK(result);
 }
 
 void Common_Thread_Destroy(void *handle)
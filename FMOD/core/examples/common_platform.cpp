@@ -9,6 +9,7 @@ Copyright (c), Firelight Technologies Pty, Ltd 2012-2025.
 #include <conio.h>
 #include <Windows.h>
 #include <Objbase.h>
+#include <tlhelp32.h>
 #include <vector>
 
 static HWND gWindow = nullptr;
@@ -193,6 +194,32 @@ void Common_TTY(const char *format, ...)
     }
 }
 
+int Common_ThreadCount()
+{
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+    if (snapshot == INVALID_HANDLE_VALUE)
+    {
+        return 0;
+    }
+
+    int count = 0;
+    THREADENTRY32 entry;
+    entry.dwSize = sizeof(entry);
+
+    if (Thread32First(snapshot, &entry))
+    {
+        do
+        {
+            if (entry.th32OwnerProcessID == GetCurrentProcessId())
+            {
+                count++;
+            }
+        } while (Thread32Next(snapshot, &entry));
+    }
+    CloseHandle(snapshot);
+    return count;
+}
+
 HFONT CreateDisplayFont()
 {
     return CreateFontA(22, 0, 0, 0, FW_DONTCARE, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_OUTLINE_PRECIS,
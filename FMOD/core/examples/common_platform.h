@@ -11,6 +11,23 @@ int FMOD_Main();
 #define Common_snprintf _snprintf
 #define Common_vsnprintf _vsnprintf
 
+/*
+    File name suffix of the example plugin DLLs, matches $(Suffix) in the plugin projects:
+    "L" for Debug and "64" for x64 only, ARM64 builds have no suffix.
+*/
+#ifdef _DEBUG
+    #define COMMON_PLUGIN_DEBUG_SUFFIX "L"
+#else
+    #define COMMON_PLUGIN_DEBUG_SUFFIX ""
+#endif
+#ifdef _M_X64
+    #define COMMON_PLUGIN_ARCH_SUFFIX "64"
+#else
+    #define COMMON_PLUGIN_ARCH_SUFFIX ""
+#endif
+#define COMMON_PLUGIN_SUFFIX COMMON_PLUGIN_DEBUG_SUFFIX COMMON_PLUGIN_ARCH_SUFFIX
+
 void Common_TTY(const char *format, ...);
+int  Common_ThreadCount();     // Threads in this process, 0 if they cannot be counted
 
 
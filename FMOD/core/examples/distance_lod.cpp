@@ -0,0 +1,220 @@
+/*==============================================================================
+Distance LOD Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how much DSP time the level of detail tiers in the
+distance filter plug-in (plugins/fmod_distance_filter.cpp) save in a scene
+with many distant emitters.
+
+Every emitter plays on its own channel with its own distance filter instance.
+The plug-in's 'LOD Dist' parameter can be toggled between off and on, with
+LOD on the filters drop to a cheaper tier (lower filter order, mono
+processing, fewer coefficient updates) the further away they are. The
+exclusive CPU time of all filter instances is averaged separately for both
+modes so the saving can be read off directly.
+
+The plug-in is loaded from fmod_distance_filter.dll, build the
+fmod_distance_filter project first.
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod.hpp"
+#include "common.h"
+
+const char *PLUGIN_FILENAME         = "fmod_distance_filter" COMMON_PLUGIN_SUFFIX ".dll";
+const int   NUM_EMITTERS            = 128;
+const int   PARAM_3D_ATTRIBUTES     = 2;    /* Parameter indices from fmod_distance_filter.cpp */
+const int   PARAM_LOD_DISTANCE      = 3;
+const float LOD_DISTANCE            = 10.0f;
+const float AVERAGE_WEIGHT          = 0.05f;
+
+int FMOD_Main()
+{
+    FMOD::System       *system;
+    FMOD::Sound        *sound;
+    FMOD::Channel      *channel[NUM_EMITTERS];
+    FMOD::DSP          *filter[NUM_EMITTERS];
+    FMOD_VECTOR         position[NUM_EMITTERS];
+    FMOD_RESULT         result;
+    unsigned int        pluginhandle;
+    bool                lodenabled = false;
+    float               radius = 40.0f;
+    float               average_us[2] = { 0.0f, 0.0f };     /* [0] = LOD off, [1] = LOD on */
+    void               *extradriverdata = 0;
+
+    Common_Init(&extradriverdata);
+
+    /*
+        Create a System object and initialize. Profiling is enabled so DSP::getCPUUsage reports per unit times.
+    */
+    result = FMOD::System_Create(&system);
+    ERRCHECK(result);
+
+    result = system->setSoftwareChannels(NUM_EMITTERS);
+    ERRCHECK(result);
+
+    result = system->init(NUM_EMITTERS, FMOD_INIT_PROFILE_ENABLE, extradriverdata);
+    ERRCHECK(result);
+
+    result = system->loadPlugin(PLUGIN_FILENAME, &pluginhandle);
+    ERRCHECK(result);
+
+    result = system->createSound(Common_MediaPath("drumloop.wav"), FMOD_3D | FMOD_LOOP_NORMAL, 0, &sound);
+    ERRCHECK(result);
+
+    /*
+        Spread the emitters around the listener, each with its own filter at the head of the channel
+    */
+    for (int i = 0; i < NUM_EMITTERS; i++)
+    {
+        result = system->playSound(sound, 0, true, &channel[i]);
+        ERRCHECK(result);
+
+        result = system->createDSPByPlugin(pluginhandle, &filter[i]);
+        ERRCHECK(result);
+
+        result = channel[i]->addDSP(0, filter[i]);
+        ERRCHECK(result);
+
+        result = channel[i]->setVolume(1.0f / NUM_EMITTERS);
+        ERRCHECK(result);
+
+        result = channel[i]->setPaused(false);
+        ERRCHECK(result);
+    }
+
+    /*
+        Main loop
+    */
+    do
+    {
+        Common_Update();
+
+        if (Common_BtnPress(BTN_ACTION1))
+        {
+            lodenabled = !lodenabled;
+
+            for (int i = 0; i < NUM_EMITTERS; i++)
+            {
+                result = filter[i]->setParameterFloat(PARAM_LOD_DISTANCE, lodenabled ? LOD_DISTANCE : 0.0f);
+                ERRCHECK(result);
+            }
+        }
+        if (Common_BtnDown(BTN_UP))
+        {
+            radius = Common_Min(radius + 0.5f, 100.0f);
+        }
+        if (Common_BtnDown(BTN_DOWN))
+        {
+            radius = Common_Max(radius - 0.5f, 1.0f);
+        }
+
+        /*
+            Position the emitters and feed each filter its relative position. The listener sits at the origin
+            with the default orientation, so relative and absolute positions are the same.
+        */
+        for (int i = 0; i < NUM_EMITTERS; i++)
+        {
+            float angle = (float)i * 6.2831853f / NUM_EMITTERS;
+            FMOD_VECTOR velocity = { 0.0f, 0.0f, 0.0f };
+            FMOD_DSP_PARAMETER_3DATTRIBUTES attributes;
+
+            /* Every other emitter sits at twice the radius so more than one tier is in use */
+            float distance = radius * ((i & 1) ? 2.0f : 1.0f);
+
+            position[i].x = Common_Sin(angle) * distance;
+            position[i].y = 0.0f;
+            position[i].z = Common_Sin(angle + 1.5707963f) * distance;
+
+            result = channel[i]->set3DAttributes(&position[i], &velocity);
+            ERRCHECK(result);
+
+            memset(&attributes, 0, sizeof(attributes));
+            attributes.relative.position = position[i];
+            attributes.relative.forward.z = 1.0f;
+            attributes.relative.up.y = 1.0f;
+            attributes.absolute = attributes.relative;
+
+            result = filter[i]->setParameterData(PARAM_3D_ATTRIBUTES, &attributes, sizeof(attributes));
+            ERRCHECK(result);
+        }
+
+        result = system->update();
+        ERRCHECK(result);
+
+        /*
+            Sum the exclusive time of every filter instance and keep a running average per mode
+        */
+        {
+            unsigned int total_us = 0;
+
+            for (int i = 0; i < NUM_EMITTERS; i++)
+            {
+                unsigned int exclusive = 0;
+
+                result = filter[i]->getCPUUsage(&exclusive, 0);
+                ERRCHECK(result);
+
+                total_us += exclusive;
+            }
+
+            float &average = average_us[lodenabled ? 1 : 0];
+            average = (average == 0.0f) ? (float)total_us : average + AVERAGE_WEIGHT * ((float)total_us - average);
+        }
+
+        {
+            FMOD_CPU_USAGE usage;
+
+            result = system->getCPUUsage(&usage);
+            ERRCHECK(result);
+
+            Common_Draw("==================================================");
+            Common_Draw("Distance LOD Example.");
+            Common_Draw("Copyright (c) Firelight Technologies 2004-2025.");
+            Common_Draw("==================================================");
+            Common_Draw("");
+            Common_Draw("Press %s to toggle distance LOD", Common_BtnStr(BTN_ACTION1));
+            Common_Draw("Hold %s / %s to move emitters closer / further", Common_BtnStr(BTN_DOWN), Common_BtnStr(BTN_UP));
+            Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+            Common_Draw("");
+            Common_Draw("Emitters         : %d at %.1f and %.1f", NUM_EMITTERS, radius, radius * 2.0f);
+            Common_Draw("LOD              : %s", lodenabled ? "On" : "Off");
+            Common_Draw("Mixer DSP CPU    : %.1f%%", usage.dsp);
+            Common_Draw("");
+            Common_Draw("Filter time, LOD off : %8.0f us", average_us[0]);
+            Common_Draw("Filter time, LOD on  : %8.0f us", average_us[1]);
+            if (average_us[0] > 0.0f && average_us[1] > 0.0f)
+            {
+                Common_Draw("Saved                : %8.1f %%", 100.0f * (1.0f - average_us[1] / average_us[0]));
+            }
+            else
+            {
+                Common_Draw("Saved                : toggle LOD to measure");
+            }
+        }
+
+        Common_Sleep(50);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    /*
+        Shut down
+    */
+    for (int i = 0; i < NUM_EMITTERS; i++)
+    {
+        result = channel[i]->removeDSP(filter[i]);
+        ERRCHECK(result);
+        result = filter[i]->release();
+        ERRCHECK(result);
+    }
+    result = sound->release();
+    ERRCHECK(result);
+    result = system->close();
+    ERRCHECK(result);
+    result = system->release();
+    ERRCHECK(result);
+
+    Common_Close();
+
+    return 0;
+}
@@ -0,0 +1,364 @@
+/*==============================================================================
+Locked Memory Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how to keep page faults off the mixer thread by
+prefaulting and locking the memory the mix touches.
+
+A small real-time memory service keeps a list of registered regions and,
+when enabled, locks them into the working set with VirtualLock in
+registration order until a configurable budget is used up. Regions past the
+budget are only prefaulted. Registered here are:
+
+ * The FMOD memory pool given to FMOD::Memory_Initialize. Every FMOD
+   allocation comes from it, including plug-in state allocated with
+   FMOD_DSP_ALLOC at create time (the echo delay line here), so plug-ins
+   are covered without registering anything themselves.
+ * A wav image loaded with Common_LoadFileMemory and played with
+   FMOD_OPENMEMORY_POINT, which FMOD reads straight from application memory.
+
+To simulate memory pressure from the rest of the process the working set is
+trimmed once a second. Page faults are counted around every mix with the
+FMOD_SYSTEM_CALLBACK_PREMIX / POSTMIX callbacks, which run on the mixer
+thread. Windows only reports a process wide fault count (soft and hard
+faults together), so faults taken by other threads during a mix are counted
+too; the main thread sleeps for most of the mix.
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod.hpp"
+#include "common.h"
+#include <psapi.h>
+
+const int    POOL_SIZE          = 32 * 1024 * 1024;
+const size_t LOCK_BUDGET        = 48 * 1024 * 1024;
+const int    MAX_REGIONS        = 16;
+const int    NUM_CHANNELS       = 16;
+const int    TRIM_INTERVAL_MS   = 1000;
+const float  AVERAGE_WEIGHT     = 0.1f;
+
+/*
+    Real-time memory service
+*/
+struct MemoryRegion
+{
+    const char *name;
+    void       *address;
+    size_t      size;
+    bool        locked;
+};
+
+struct RealtimeMemory
+{
+    size_t          budget;
+    size_t          lockedBytes;
+    bool            enabled;
+    int             numRegions;
+    MemoryRegion    region[MAX_REGIONS];
+};
+
+void RealtimeMemory_Init(RealtimeMemory *memory, size_t budget)
+{
+    memset(memory, 0, sizeof(RealtimeMemory));
+    memory->budget = budget;
+
+    /* VirtualLock fails once the locked pages no longer fit in the minimum working set, so grow it by the budget */
+    SIZE_T minimum, maximum;
+    GetProcessWorkingSetSize(GetCurrentProcess(), &minimum, &maximum);
+    if (!SetProcessWorkingSetSize(GetCurrentProcess(), minimum + budget, maximum + budget))
+    {
+        Common_Fatal("SetProcessWorkingSetSize failed (%lu)", GetLastError());
+    }
+}
+
+void RealtimeMemory_Register(RealtimeMemory *memory, const char *name, void *address, size_t size)
+{
+    if (memory->numRegions == MAX_REGIONS)
+    {
+        Common_Fatal("Too many real-time memory regions");
+    }
+
+    MemoryRegion *region = &memory->region[memory->numRegions++];
+    region->name = name;
+    region->address = address;
+    region->size = size;
+    region->locked = false;
+}
+
+void RealtimeMemory_Prefault(MemoryRegion *region)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+
+    volatile const char *bytes = (volatile const char *)region->address;
+    for (size_t offset = 0; offset < region->size; offset += info.dwPageSize)
+    {
+        (void)bytes[offset];
+    }
+}
+
+void RealtimeMemory_Lock(RealtimeMemory *memory)
+{
+    for (int i = 0; i < memory->numRegions; i++)
+    {
+        MemoryRegion *region = &memory->region[i];
+
+        if (!region->locked && memory->lockedBytes + region->size <= memory->budget && VirtualLock(region->address, region->size))
+        {
+            region->locked = true;
+            memory->lockedBytes += region->size;
+        }
+        else if (!region->locked)
+        {
+            RealtimeMemory_Prefault(region);
+        }
+    }
+    memory->enabled = true;
+}
+
+void RealtimeMemory_Unlock(RealtimeMemory *memory)
+{
+    for (int i = 0; i < memory->numRegions; i++)
+    {
+        MemoryRegion *region = &memory->region[i];
+
+        if (region->locked)
+        {
+            VirtualUnlock(region->address, region->size);
+            region->locked = false;
+        }
+    }
+    memory->lockedBytes = 0;
+    memory->enabled = false;
+}
+
+/*
+    Fault counting around each mix, called on the mixer thread
+*/
+struct MixFaults
+{
+    DWORD           premixCount;
+    volatile DWORD  total;
+    volatile DWORD  worst;          /* Most faults in a single mix */
+    volatile DWORD  mixes;
+};
+
+DWORD getPageFaultCount()
+{
+    PROCESS_MEMORY_COUNTERS counters;
+    counters.cb = sizeof(counters);
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PageFaultCount;
+}
+
+FMOD_RESULT F_CALL mixCallback(FMOD_SYSTEM *system, FMOD_SYSTEM_CALLBACK_TYPE type, void * /*commanddata1*/, void * /*commanddata2*/, void * /*userdata*/)
+{
+    MixFaults *faults;
+    ((FMOD::System *)system)->getUserData((void **)&faults);
+
+    if (type == FMOD_SYSTEM_CALLBACK_PREMIX)
+    {
+        faults->premixCount = getPageFaultCount();
+    }
+    else
+    {
+        DWORD count = getPageFaultCount() - faults->premixCount;
+        faults->total += count;
+        faults->worst = Common_Max(faults->worst, count);
+        faults->mixes++;
+    }
+
+    return FMOD_OK;
+}
+
+int FMOD_Main()
+{
+    FMOD::System       *system;
+    FMOD::Sound        *sound[4];
+    FMOD::DSP          *echo;
+    FMOD::ChannelGroup *mastergroup;
+    FMOD_RESULT         result;
+    RealtimeMemory      memory;
+    MixFaults           faults;
+    void               *image;
+    int                 imagelength;
+    unsigned int        lasttrim, lastsample;
+    DWORD               lasttotal = 0;
+    float               faultspersec[2] = { 0.0f, 0.0f };   /* [0] = unlocked, [1] = locked */
+    DWORD               worst[2] = { 0, 0 };
+    void               *extradriverdata = 0;
+
+    Common_Init(&extradriverdata);
+
+    /*
+        Give FMOD a fixed pool so everything it allocates lives in one registered region
+    */
+    void *pool = VirtualAlloc(0, POOL_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!pool)
+    {
+        Common_Fatal("Could not allocate the FMOD memory pool");
+    }
+
+    result = FMOD::Memory_Initialize(pool, POOL_SIZE, 0, 0, 0);
+    ERRCHECK(result);
+
+    RealtimeMemory_Init(&memory, LOCK_BUDGET);
+    RealtimeMemory_Register(&memory, "FMOD pool", pool, POOL_SIZE);
+
+    /*
+        Create a System object and initialize
+    */
+    result = FMOD::System_Create(&system);
+    ERRCHECK(result);
+
+    result = system->init(32, FMOD_INIT_NORMAL, extradriverdata);
+    ERRCHECK(result);
+
+    memset(&faults, 0, sizeof(faults));
+    result = system->setUserData(&faults);
+    ERRCHECK(result);
+    result = system->setCallback(mixCallback, FMOD_SYSTEM_CALLBACK_PREMIX | FMOD_SYSTEM_CALLBACK_POSTMIX);
+    ERRCHECK(result);
+
+    /*
+        Samples decoded into the pool, plus one wav FMOD reads in place from application memory
+    */
+    result = system->createSound(Common_MediaPath("drumloop.wav"), FMOD_LOOP_NORMAL | FMOD_CREATESAMPLE, 0, &sound[0]);
+    ERRCHECK(result);
+    result = system->createSound(Common_MediaPath("jaguar.wav"), FMOD_LOOP_NORMAL | FMOD_CREATESAMPLE, 0, &sound[1]);
+    ERRCHECK(result);
+    result = system->createSound(Common_MediaPath("swish.wav"), FMOD_LOOP_NORMAL | FMOD_CREATESAMPLE, 0, &sound[2]);
+    ERRCHECK(result);
+
+    Common_LoadFileMemory(Common_MediaPath("standrews.wav"), &image, &imagelength);
+    RealtimeMemory_Register(&memory, "standrews.wav image", image, imagelength);
+    {
+        FMOD_CREATESOUNDEXINFO exinfo;
+        memset(&exinfo, 0, sizeof(FMOD_CREATESOUNDEXINFO));
+        exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+        exinfo.length = imagelength;
+
+        result = system->createSound((const char *)image, FMOD_OPENMEMORY_POINT | FMOD_CREATESAMPLE | FMOD_LOOP_NORMAL, &exinfo, &sound[3]);
+        ERRCHECK(result);
+    }
+
+    /*
+        An echo on the master group, its delay line is plug-in state allocated from the pool
+    */
+    result = system->createDSPByType(FMOD_DSP_TYPE_ECHO, &echo);
+    ERRCHECK(result);
+    result = system->getMasterChannelGroup(&mastergroup);
+    ERRCHECK(result);
+    result = mastergroup->addDSP(0, echo);
+    ERRCHECK(result);
+
+    for (int i = 0; i < NUM_CHANNELS; i++)
+    {
+        FMOD::Channel *channel;
+
+        result = system->playSound(sound[i % 4], 0, false, &channel);
+        ERRCHECK(result);
+        result = channel->setVolume(1.0f / NUM_CHANNELS);
+        ERRCHECK(result);
+    }
+
+    Common_Time_GetUs(&lasttrim);
+    lastsample = lasttrim;
+
+    /*
+        Main loop
+    */
+    do
+    {
+        Common_Update();
+
+        if (Common_BtnPress(BTN_ACTION1))
+        {
+            if (memory.enabled)
+            {
+                RealtimeMemory_Unlock(&memory);
+            }
+            else
+            {
+                RealtimeMemory_Lock(&memory);
+            }
+        }
+
+        result = system->update();
+        ERRCHECK(result);
+
+        unsigned int now;
+        Common_Time_GetUs(&now);
+
+        /* Memory pressure, pages that are not locked leave the working set and fault back in on next touch */
+        if (now - lasttrim > TRIM_INTERVAL_MS * 1000)
+        {
+            SetProcessWorkingSetSize(GetCurrentProcess(), (SIZE_T)-1, (SIZE_T)-1);
+            lasttrim = now;
+        }
+
+        /* Faults per second during mixes, averaged per mode */
+        {
+            DWORD total = faults.total;
+            float seconds = (now - lastsample) / 1000000.0f;
+            float rate = (total - lasttotal) / seconds;
+            float &average = faultspersec[memory.enabled ? 1 : 0];
+
+            average = average + AVERAGE_WEIGHT * (rate - average);
+            worst[memory.enabled ? 1 : 0] = Common_Max(worst[memory.enabled ? 1 : 0], (DWORD)faults.worst);
+            faults.worst = 0;
+
+            lasttotal = total;
+            lastsample = now;
+        }
+
+        Common_Draw("==================================================");
+        Common_Draw("Locked Memory Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2004-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("");
+        Common_Draw("Press %s to toggle locking", Common_BtnStr(BTN_ACTION1));
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+        Common_Draw("");
+        Common_Draw("Locking : %s, %.1f of %.1f MB budget", memory.enabled ? "On" : "Off", memory.lockedBytes / 1048576.0f, memory.budget / 1048576.0f);
+        for (int i = 0; i < memory.numRegions; i++)
+        {
+            Common_Draw("  %-22s %7.1f MB %s", memory.region[i].name, memory.region[i].size / 1048576.0f,
+                memory.region[i].locked ? "locked" : (memory.enabled ? "prefaulted" : "-"));
+        }
+        Common_Draw("");
+        Common_Draw("Mix page faults    per sec   worst mix");
+        Common_Draw("  Unlocked        %8.1f   %9lu", faultspersec[0], worst[0]);
+        Common_Draw("  Locked          %8.1f   %9lu", faultspersec[1], worst[1]);
+        Common_Draw("Mixes             %8lu", (DWORD)faults.mixes);
+
+        Common_Sleep(50);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    /*
+        Shut down
+    */
+    RealtimeMemory_Unlock(&memory);
+
+    result = mastergroup->removeDSP(echo);
+    ERRCHECK(result);
+    result = echo->release();
+    ERRCHECK(result);
+    for (int i = 0; i < 4; i++)
+    {
+        result = sound[i]->release();
+        ERRCHECK(result);
+    }
+    result = system->close();
+    ERRCHECK(result);
+    result = system->release();
+    ERRCHECK(result);
+
+    Common_UnloadFileMemory(image);
+    VirtualFree(pool, 0, MEM_RELEASE);
+
+    Common_Close();
+
+    return 0;
+}
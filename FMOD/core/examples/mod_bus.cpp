@@ -0,0 +1,289 @@
+/*==============================================================================
+Modulation Bus Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how effects can share modulation sources through the
+modulation bus plugin (fmod_modbus.dll), and measures the cost against
+every effect instance computing its own.
+
+Hundreds of voices are played, each with a tremolo from the plugin. Engine
+voices use an LFO, radio chatter a random wobble and a few voices swell
+in with an envelope while it is gated. The three sources are defined once
+on the bus. In shared mode the plugin renders each of them once per mix in
+its sys_mix callback and the instances read the result, in private mode
+every instance renders its own copy of the same source.
+
+Shown per mode is the time spent in the effect instances from
+DSP::getCPUUsage (FMOD_INIT_PROFILE_ENABLE) and the DSP CPU from
+System::getCPUUsage, which also covers the bus rendered in sys_mix.
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod.hpp"
+#include "common.h"
+#include "plugins/fmod_modbus.h"
+#include <string.h>
+
+const char *MODBUS_FILENAME = "fmod_modbus" COMMON_PLUGIN_SUFFIX ".dll";
+
+const int   MAX_VOICES      = 512;
+const int   START_VOICES    = 256;
+const int   VOICE_STEP      = 32;
+
+enum SourceId
+{
+    SOURCE_ENGINE,
+    SOURCE_RADIO,
+    SOURCE_SWELL,
+    SOURCE_COUNT
+};
+
+struct ModeStats
+{
+    double          instanceUs;     /* Sum over sampled blocks of the exclusive time of every instance */
+    double          dsp;            /* Sum of System::getCPUUsage dsp */
+    unsigned int    samples;
+};
+
+void defineSources(FMOD::DSP *bus, bool gate)
+{
+    FMOD_RESULT         result;
+    FMOD_MODBUS_SOURCE  source;
+
+    memset(&source, 0, sizeof(source));
+    source.id = SOURCE_ENGINE;
+    source.type = FMOD_MODBUS_TYPE_LFO;
+    source.shape = FMOD_MODBUS_SHAPE_SINE;
+    source.rate = 7.0f;
+    result = bus->setParameterData(FMOD_MODBUS_PARAM_DEFINE, &source, sizeof(source));
+    ERRCHECK(result);
+
+    memset(&source, 0, sizeof(source));
+    source.id = SOURCE_RADIO;
+    source.type = FMOD_MODBUS_TYPE_RANDOM;
+    source.rate = 6.0f;
+    result = bus->setParameterData(FMOD_MODBUS_PARAM_DEFINE, &source, sizeof(source));
+    ERRCHECK(result);
+
+    /*
+        With a depth of 1 these voices are only heard while the envelope is gated
+    */
+    memset(&source, 0, sizeof(source));
+    source.id = SOURCE_SWELL;
+    source.type = FMOD_MODBUS_TYPE_ENVELOPE;
+    source.attack = 0.05f;
+    source.decay = 0.0f;
+    source.sustain = 1.0f;
+    source.release = 0.4f;
+    source.gate = gate;
+    result = bus->setParameterData(FMOD_MODBUS_PARAM_DEFINE, &source, sizeof(source));
+    ERRCHECK(result);
+}
+
+void resetStats(ModeStats *stats)
+{
+    memset(stats, 0, sizeof(ModeStats) * 2);
+}
+
+int FMOD_Main()
+{
+    FMOD::System       *system;
+    FMOD::Sound        *engine, *radio;
+    FMOD::Channel      *channels[MAX_VOICES];
+    FMOD::DSP          *effects[MAX_VOICES];
+    FMOD::DSP          *bus;
+    FMOD_RESULT         result;
+    unsigned int        handle;
+    ModeStats           stats[2];           /* [0] private, [1] shared */
+    int                 numvoices = START_VOICES;
+    bool                shared = true;
+    bool                gate = false;
+    void               *extradriverdata = 0;
+
+    Common_Init(&extradriverdata);
+
+    /*
+        Create a System object and initialize. Every voice has to be real for the comparison.
+    */
+    result = FMOD::System_Create(&system);
+    ERRCHECK(result);
+
+    result = system->setSoftwareChannels(MAX_VOICES);
+    ERRCHECK(result);
+
+    result = system->init(MAX_VOICES, FMOD_INIT_PROFILE_ENABLE, extradriverdata);
+    ERRCHECK(result);
+
+    result = system->loadPlugin(MODBUS_FILENAME, &handle);
+    ERRCHECK(result);
+
+    /*
+        Sources can be defined on any instance, this one is never connected and only talks to the bus
+    */
+    result = system->createDSPByPlugin(handle, &bus);
+    ERRCHECK(result);
+    defineSources(bus, gate);
+
+    result = system->createSound(Common_MediaPath("drumloop.wav"), FMOD_LOOP_NORMAL, 0, &engine);
+    ERRCHECK(result);
+    result = system->createSound(Common_MediaPath("standrews.wav"), FMOD_LOOP_NORMAL, 0, &radio);
+    ERRCHECK(result);
+
+    /*
+        Two thirds engines, one third radio, every eighth voice follows the envelope
+    */
+    for (int i = 0; i < MAX_VOICES; i++)
+    {
+        int source = (i % 8 == 7) ? SOURCE_SWELL : (i % 3 == 2) ? SOURCE_RADIO : SOURCE_ENGINE;
+
+        result = system->playSound(source == SOURCE_RADIO ? radio : engine, 0, true, &channels[i]);
+        ERRCHECK(result);
+        result = channels[i]->setVolume(0.5f / START_VOICES);
+        ERRCHECK(result);
+
+        result = system->createDSPByPlugin(handle, &effects[i]);
+        ERRCHECK(result);
+        result = effects[i]->setParameterInt(FMOD_MODBUS_PARAM_SOURCE, source);
+        ERRCHECK(result);
+        result = effects[i]->setParameterFloat(FMOD_MODBUS_PARAM_DEPTH, source == SOURCE_SWELL ? 1.0f : 0.6f);
+        ERRCHECK(result);
+        result = channels[i]->addDSP(0, effects[i]);
+        ERRCHECK(result);
+
+        result = channels[i]->setPaused(i >= numvoices);
+        ERRCHECK(result);
+    }
+
+    resetStats(stats);
+
+    /*
+        Main loop
+    */
+    do
+    {
+        Common_Update();
+
+        if (Common_BtnPress(BTN_ACTION1))
+        {
+            shared = !shared;
+            for (int i = 0; i < MAX_VOICES; i++)
+            {
+                result = effects[i]->setParameterBool(FMOD_MODBUS_PARAM_SHARED, shared);
+                ERRCHECK(result);
+            }
+            stats[shared].instanceUs = 0;
+            stats[shared].dsp = 0;
+            stats[shared].samples = 0;
+        }
+
+        if (Common_BtnPress(BTN_ACTION2))
+        {
+            gate = !gate;
+            defineSources(bus, gate);
+        }
+
+        int newvoices = numvoices;
+        if (Common_BtnPress(BTN_UP))
+        {
+            newvoices = Common_Min(numvoices + VOICE_STEP, MAX_VOICES);
+        }
+        if (Common_BtnPress(BTN_DOWN))
+        {
+            newvoices = Common_Max(numvoices - VOICE_STEP, VOICE_STEP);
+        }
+        if (newvoices != numvoices)
+        {
+            numvoices = newvoices;
+            for (int i = 0; i < MAX_VOICES; i++)
+            {
+                result = channels[i]->setPaused(i >= numvoices);
+                ERRCHECK(result);
+            }
+            resetStats(stats);
+        }
+
+        result = system->update();
+        ERRCHECK(result);
+
+        /*
+            Sample the last block
+        */
+        unsigned int blockUs = 0;
+        for (int i = 0; i < numvoices; i++)
+        {
+            unsigned int exclusive, inclusive;
+            result = effects[i]->getCPUUsage(&exclusive, &inclusive);
+            ERRCHECK(result);
+            blockUs += exclusive;
+        }
+
+        FMOD_CPU_USAGE cpu;
+        result = system->getCPUUsage(&cpu);
+        ERRCHECK(result);
+
+        if (blockUs > 0)
+        {
+            stats[shared].instanceUs += blockUs;
+            stats[shared].dsp += cpu.dsp;
+            stats[shared].samples++;
+        }
+
+        Common_Draw("==================================================");
+        Common_Draw("Modulation Bus Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2004-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("");
+        Common_Draw("Press %s to toggle shared and private sources", Common_BtnStr(BTN_ACTION1));
+        Common_Draw("Press %s to toggle the swell envelope", Common_BtnStr(BTN_ACTION2));
+        Common_Draw("Press %s or %s to change the voice count", Common_BtnStr(BTN_UP), Common_BtnStr(BTN_DOWN));
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+        Common_Draw("");
+        Common_Draw("Sources  : %s", shared ? "Shared, rendered once per mix" : "Private, rendered per instance");
+        Common_Draw("Voices   : %d", numvoices);
+        Common_Draw("Swell    : %s", gate ? "Gated" : "Released");
+        Common_Draw("DSP CPU  : %5.1f%%", cpu.dsp);
+        Common_Draw("");
+        Common_Draw("Mode       us/block  us/voice  DSP CPU");
+
+        for (int m = 1; m >= 0; m--)
+        {
+            const ModeStats *s = &stats[m];
+            if (!s->samples)
+            {
+                Common_Draw("%-8s          -         -        -", m ? "Shared" : "Private");
+                continue;
+            }
+
+            double perBlock = s->instanceUs / s->samples;
+            Common_Draw("%-8s  %8.0f  %8.2f  %6.1f%%", m ? "Shared" : "Private", perBlock, perBlock / numvoices, s->dsp / s->samples);
+        }
+
+        Common_Sleep(50);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    /*
+        Shut down
+    */
+    for (int i = 0; i < MAX_VOICES; i++)
+    {
+        result = channels[i]->removeDSP(effects[i]);
+        ERRCHECK(result);
+        result = effects[i]->release();
+        ERRCHECK(result);
+    }
+    result = bus->release();
+    ERRCHECK(result);
+    result = engine->release();
+    ERRCHECK(result);
+    result = radio->release();
+    ERRCHECK(result);
+    result = system->close();
+    ERRCHECK(result);
+    result = system->release();
+    ERRCHECK(result);
+
+    Common_Close();
+
+    return 0;
+}
@@ -0,0 +1,317 @@
+/*==============================================================================
+Pitch Shift Benchmark Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example compares the cost of the time domain pitch shifter plugin
+(fmod_wsola.dll) against the built in FFT based FMOD_DSP_TYPE_PITCHSHIFT.
+
+A number of looping voices are played, each with its own pitch shift
+effect. The mixer block size is 1024 samples and the built in unit is set
+to an FFT size of 1024, so both process the same block sizes. The cost of
+every effect is read with DSP::getCPUUsage (FMOD_INIT_PROFILE_ENABLE) and
+averaged per voice and per block. The average of each mode is kept so the
+plugin qualities can be compared with the built in unit after cycling
+through them.
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod.hpp"
+#include "common.h"
+
+const char *WSOLA_FILENAME      = "fmod_wsola" COMMON_PLUGIN_SUFFIX ".dll";
+const int   WSOLA_PARAM_PITCH   = 0;    /* Parameter indices as published by fmod_wsola.dll */
+const int   WSOLA_PARAM_QUALITY = 1;
+
+const int   NUM_VOICES          = 32;
+const int   BLOCK_SIZE          = 1024;
+
+enum BenchMode
+{
+    MODE_NONE,
+    MODE_BUILTIN,
+    MODE_WSOLA_FAST,
+    MODE_WSOLA_NORMAL,
+    MODE_WSOLA_HIGH,
+    MODE_COUNT
+};
+
+const char *MODE_NAMES[MODE_COUNT] = { "None", "Built in FFT", "WSOLA Fast", "WSOLA Normal", "WSOLA High" };
+
+struct ModeStats
+{
+    double          totalUs;    /* Sum of exclusive DSP time over all sampled blocks and voices */
+    unsigned int    samples;
+    float           averageUs;  /* Per voice, per block */
+};
+
+void setPitch(FMOD::DSP *dsp, BenchMode mode, float pitch)
+{
+    FMOD_RESULT result;
+
+    if (mode == MODE_BUILTIN)
+    {
+        result = dsp->setParameterFloat(FMOD_DSP_PITCHSHIFT_PITCH, pitch);
+    }
+    else
+    {
+        result = dsp->setParameterFloat(WSOLA_PARAM_PITCH, pitch);
+    }
+    ERRCHECK(result);
+}
+
+FMOD::DSP *createEffect(FMOD::System *system, unsigned int wsolaHandle, BenchMode mode, float pitch)
+{
+    FMOD_RESULT result;
+    FMOD::DSP  *dsp;
+
+    if (mode == MODE_BUILTIN)
+    {
+        result = system->createDSPByType(FMOD_DSP_TYPE_PITCHSHIFT, &dsp);
+        ERRCHECK(result);
+        result = dsp->setParameterFloat(FMOD_DSP_PITCHSHIFT_FFTSIZE, (float)BLOCK_SIZE);
+        ERRCHECK(result);
+    }
+    else
+    {
+        result = system->createDSPByPlugin(wsolaHandle, &dsp);
+        ERRCHECK(result);
+        result = dsp->setParameterInt(WSOLA_PARAM_QUALITY, mode - MODE_WSOLA_FAST);
+        ERRCHECK(result);
+    }
+
+    setPitch(dsp, mode, pitch);
+    return dsp;
+}
+
+void releaseEffects(FMOD::Channel **channels, FMOD::DSP **effects)
+{
+    FMOD_RESULT result;
+
+    for (int i = 0; i < NUM_VOICES; i++)
+    {
+        if (effects[i])
+        {
+            result = channels[i]->removeDSP(effects[i]);
+            ERRCHECK(result);
+            result = effects[i]->release();
+            ERRCHECK(result);
+            effects[i] = 0;
+        }
+    }
+}
+
+int FMOD_Main()
+{
+    FMOD::System       *system;
+    FMOD::Sound        *sound;
+    FMOD::Channel      *channels[NUM_VOICES];
+    FMOD::DSP          *effects[NUM_VOICES] = { 0 };
+    FMOD_RESULT         result;
+    unsigned int        wsolaHandle;
+    BenchMode           mode = MODE_BUILTIN;
+    ModeStats           stats[MODE_COUNT] = { };
+    float               pitch = 1.3f;
+    void               *extradriverdata = 0;
+
+    Common_Init(&extradriverdata);
+
+    /*
+        Create a System object and initialize
+    */
+    result = FMOD::System_Create(&system);
+    ERRCHECK(result);
+
+    result = system->setDSPBufferSize(BLOCK_SIZE, 4);
+    ERRCHECK(result);
+
+    result = system->init(NUM_VOICES, FMOD_INIT_PROFILE_ENABLE, extradriverdata);
+    ERRCHECK(result);
+
+    result = system->loadPlugin(WSOLA_FILENAME, &wsolaHandle);
+    ERRCHECK(result);
+
+    result = system->createSound(Common_MediaPath("singing.wav"), FMOD_LOOP_NORMAL | FMOD_CREATESAMPLE, 0, &sound);
+    ERRCHECK(result);
+
+    /*
+        Start every voice at a different offset and keep the total level sane
+    */
+    unsigned int length;
+    result = sound->getLength(&length, FMOD_TIMEUNIT_PCM);
+    ERRCHECK(result);
+
+    for (int i = 0; i < NUM_VOICES; i++)
+    {
+        result = system->playSound(sound, 0, true, &channels[i]);
+        ERRCHECK(result);
+        result = channels[i]->setPosition(length / NUM_VOICES * i, FMOD_TIMEUNIT_PCM);
+        ERRCHECK(result);
+        result = channels[i]->setVolume(1.0f / NUM_VOICES);
+        ERRCHECK(result);
+        result = channels[i]->setPaused(false);
+        ERRCHECK(result);
+    }
+
+    bool rebuild = true;
+
+    /*
+        Main loop
+    */
+    do
+    {
+        Common_Update();
+
+        if (Common_BtnPress(BTN_ACTION1))
+        {
+            mode = (BenchMode)((mode + 1) % MODE_COUNT);
+            rebuild = true;
+        }
+
+        float newPitch = pitch;
+        if (Common_BtnPress(BTN_UP))
+        {
+            newPitch = Common_Min(pitch + 0.05f, 2.0f);
+        }
+        if (Common_BtnPress(BTN_DOWN))
+        {
+            newPitch = Common_Max(pitch - 0.05f, 0.5f);
+        }
+
+        if (newPitch != pitch)
+        {
+            pitch = newPitch;
+
+            for (int i = 0; i < NUM_VOICES; i++)
+            {
+                if (effects[i])
+                {
+                    setPitch(effects[i], mode, pitch);
+                }
+            }
+
+            /*
+                Cost depends on the ratio, start the averages again
+            */
+            for (int m = 0; m < MODE_COUNT; m++)
+            {
+                stats[m].totalUs = 0;
+                stats[m].samples = 0;
+                stats[m].averageUs = 0;
+            }
+        }
+
+        if (rebuild)
+        {
+            releaseEffects(channels, effects);
+
+            if (mode != MODE_NONE)
+            {
+                for (int i = 0; i < NUM_VOICES; i++)
+                {
+                    effects[i] = createEffect(system, wsolaHandle, mode, pitch);
+                    result = channels[i]->addDSP(0, effects[i]);
+                    ERRCHECK(result);
+                }
+            }
+
+            stats[mode].totalUs = 0;
+            stats[mode].samples = 0;
+            rebuild = false;
+        }
+
+        result = system->update();
+        ERRCHECK(result);
+
+        /*
+            Sample the last block of every effect. Each one reports the exclusive
+            time it spent in its own read callback.
+        */
+        if (mode != MODE_NONE)
+        {
+            unsigned int blockUs = 0;
+
+            for (int i = 0; i < NUM_VOICES; i++)
+            {
+                unsigned int exclusive, inclusive;
+                result = effects[i]->getCPUUsage(&exclusive, &inclusive);
+                ERRCHECK(result);
+                blockUs += exclusive;
+            }
+
+            if (blockUs > 0)
+            {
+                stats[mode].totalUs += blockUs;
+                stats[mode].samples++;
+                stats[mode].averageUs = (float)(stats[mode].totalUs / ((double)stats[mode].samples * NUM_VOICES));
+            }
+        }
+
+        FMOD_CPU_USAGE cpu;
+        result = system->getCPUUsage(&cpu);
+        ERRCHECK(result);
+
+        int rate;
+        result = system->getSoftwareFormat(&rate, 0, 0);
+        ERRCHECK(result);
+
+        float blockMs = 1000.0f * BLOCK_SIZE / rate;
+
+        Common_Draw("==================================================");
+        Common_Draw("Pitch Shift Benchmark Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2004-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("");
+        Common_Draw("Press %s to change effect", Common_BtnStr(BTN_ACTION1));
+        Common_Draw("Press %s or %s to change pitch", Common_BtnStr(BTN_UP), Common_BtnStr(BTN_DOWN));
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+        Common_Draw("");
+        Common_Draw("Effect : %s on %d voices", MODE_NAMES[mode], NUM_VOICES);
+        Common_Draw("Pitch  : %.2f", pitch);
+        Common_Draw("Block  : %d samples (%.1f ms)", BLOCK_SIZE, blockMs);
+        Common_Draw("DSP    : %5.1f%%", cpu.dsp);
+        Common_Draw("");
+        Common_Draw("Effect        us/block  %%block  vs FFT");
+
+        for (int m = MODE_BUILTIN; m < MODE_COUNT; m++)
+        {
+            if (stats[m].samples == 0)
+            {
+                Common_Draw("%-13s         -       -       -", MODE_NAMES[m]);
+                continue;
+            }
+
+            float percentBlock = stats[m].averageUs / (blockMs * 10.0f);
+
+            if (stats[MODE_BUILTIN].samples > 0 && stats[MODE_BUILTIN].averageUs > 0)
+            {
+                Common_Draw("%-13s %9.1f %6.2f%% %6.0f%%", MODE_NAMES[m], stats[m].averageUs, percentBlock, 100.0f * stats[m].averageUs / stats[MODE_BUILTIN].averageUs);
+            }
+            else
+            {
+                Common_Draw("%-13s %9.1f %6.2f%%       -", MODE_NAMES[m], stats[m].averageUs, percentBlock);
+            }
+        }
+
+        Common_Draw("");
+        Common_Draw("Costs are per voice, %%block is the share of");
+        Common_Draw("one block period on the mixer thread.");
+
+        Common_Sleep(50);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    /*
+        Shut down
+    */
+    releaseEffects(channels, effects);
+    result = sound->release();
+    ERRCHECK(result);
+    result = system->close();
+    ERRCHECK(result);
+    result = system->release();
+    ERRCHECK(result);
+
+    Common_Close();
+
+    return 0;
+}
@@ -0,0 +1,586 @@
+/*==============================================================================
+Effect Chain DSP Plugin Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how to host several effect plugins inside a single DSP.
+
+Each effect in a per voice chain normally costs one node in the FMOD DSP
+graph, with its own buffers and connection. This plugin takes a list of
+FMOD_DSP_DESCRIPTIONs (for example those of fmod_gain and
+fmod_distance_filter obtained with System::getDSPInfoByPlugin), creates an
+instance of each and runs their callbacks back to back on one block, ping
+ponging between two small scratch buffers that stay in cache. Parameters of
+the hosted effects are set through FMOD_CHAIN_PARAM_FORWARD by (slot, index).
+
+The hosted effects must keep the channel count they are given. The slots
+can be changed while the chain is playing, see FMODChainSet.
+==============================================================================*/
+
+#ifdef WIN32
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <new>
+
+#include "fmod.hpp"
+#include "fmod_chain.h"
+
+extern "C" {
+    F_EXPORT FMOD_DSP_DESCRIPTION* F_CALL FMODGetDSPDescription();
+}
+
+FMOD_RESULT F_CALL FMOD_Chain_dspcreate       (FMOD_DSP_STATE *dsp_state);
+FMOD_RESULT F_CALL FMOD_Chain_dsprelease      (FMOD_DSP_STATE *dsp_state);
+FMOD_RESULT F_CALL FMOD_Chain_dspreset        (FMOD_DSP_STATE *dsp_state);
+FMOD_RESULT F_CALL FMOD_Chain_dspprocess      (FMOD_DSP_STATE *dsp_state, unsigned int length, const FMOD_DSP_BUFFER_ARRAY *inbufferarray, FMOD_DSP_BUFFER_ARRAY *outbufferarray, FMOD_BOOL inputsidle, FMOD_DSP_PROCESS_OPERATION op);
+FMOD_RESULT F_CALL FMOD_Chain_dspsetparamdata (FMOD_DSP_STATE *dsp_state, int index, void *data, unsigned int length);
+FMOD_RESULT F_CALL FMOD_Chain_dspgetparamdata (FMOD_DSP_STATE *dsp_state, int index, void **value, unsigned int *length, char *valuestr);
+
+static FMOD_DSP_PARAMETER_DESC p_slots;
+static FMOD_DSP_PARAMETER_DESC p_forward;
+
+FMOD_DSP_PARAMETER_DESC *FMOD_Chain_dspparam[FMOD_CHAIN_NUM_PARAMETERS] =
+{
+    &p_slots,
+    &p_forward
+};
+
+FMOD_DSP_DESCRIPTION FMOD_Chain_Desc =
+{
+    FMOD_PLUGIN_SDK_VERSION,
+    "FMOD Chain",   // name
+    0x00010000,     // plug-in version
+    1,              // number of input buffers to process
+    1,              // number of output buffers to process
+    FMOD_Chain_dspcreate,
+    FMOD_Chain_dsprelease,
+    FMOD_Chain_dspreset,
+    0,
+    FMOD_Chain_dspprocess,
+    0,
+    FMOD_CHAIN_NUM_PARAMETERS,
+    FMOD_Chain_dspparam,
+    0, // FMOD_Chain_dspsetparamfloat,
+    0, // FMOD_Chain_dspsetparamint,
+    0, // FMOD_Chain_dspsetparambool,
+    FMOD_Chain_dspsetparamdata,
+    0, // FMOD_Chain_dspgetparamfloat,
+    0, // FMOD_Chain_dspgetparamint,
+    0, // FMOD_Chain_dspgetparambool,
+    FMOD_Chain_dspgetparamdata,
+    0, // shouldiprocess, handled by the query in FMOD_Chain_dspprocess
+    0,                                      // userdata
+    0,                                      // sys_register
+    0,                                      // sys_deregister
+    0                                       // sys_mix
+};
+
+extern "C"
+{
+
+F_EXPORT FMOD_DSP_DESCRIPTION* F_CALL FMODGetDSPDescription()
+{
+    FMOD_DSP_INIT_PARAMDESC_DATA(p_slots,   "Slots",   "", "FMOD_CHAIN_SLOTS, effects to host in processing order",     FMOD_DSP_PARAMETER_DATA_TYPE_USER);
+    FMOD_DSP_INIT_PARAMDESC_DATA(p_forward, "Forward", "", "FMOD_CHAIN_PARAMETER, sets a parameter on a hosted effect", FMOD_DSP_PARAMETER_DATA_TYPE_USER);
+    return &FMOD_Chain_Desc;
+}
+
+}
+
+/*
+    One set of hosted effects. setSlots builds a new set on the calling thread and hands it to the mixer through
+    'm_pending', the mixer swaps it in at the start of its next query or process and pushes the set it replaced
+    onto the 'm_retired' list, which is released by the next setSlots (or by release). Hosted create and release
+    callbacks never run while the mixer may be inside the same set.
+*/
+struct FMODChainSet
+{
+    FMOD_CHAIN_SLOTS slots;
+    FMOD_DSP_STATE   state[FMOD_CHAIN_MAX_SLOTS];   // per hosted effect state, sharing the host's instance and functions
+    FMODChainSet    *next;                          // link in the retired list
+};
+
+class FMODChainState
+{
+public:
+    FMODChainState(FMOD_DSP_STATE *dsp_state);
+
+    FMOD_RESULT init        (FMOD_DSP_STATE *dsp_state);
+    void        release     ();
+    FMOD_RESULT setSlots    (const FMOD_CHAIN_SLOTS *slots);
+    FMOD_RESULT forward     (const FMOD_CHAIN_PARAMETER *param);
+    FMOD_RESULT query       (FMOD_DSP_STATE *dsp_state, unsigned int length, const FMOD_DSP_BUFFER_ARRAY *inbufferarray, FMOD_DSP_BUFFER_ARRAY *outbufferarray, FMOD_BOOL inputsidle);
+    FMOD_RESULT process     (unsigned int length, const FMOD_DSP_BUFFER_ARRAY *inbufferarray, FMOD_DSP_BUFFER_ARRAY *outbufferarray, FMOD_BOOL inputsidle);
+    void        reset       ();
+    const FMOD_CHAIN_SLOTS *slots() const;
+
+private:
+    FMOD_RESULT runSlot     (FMODChainSet *set, int slot, float *inbuffer, float *outbuffer, unsigned int length, int channels, FMOD_CHANNELMASK mask, FMOD_SPEAKERMODE speakermode, FMOD_BOOL inputsidle);
+    FMODChainSet *current   ();
+    FMODChainSet *latest    () const;
+    void        releaseSet  (FMODChainSet *set);
+    void        releaseRetired();
+
+    FMOD_DSP_STATE              *m_host;
+    FMODChainSet                *m_active;      // mixer thread only
+    std::atomic<FMODChainSet *>  m_pending;     // set by setSlots, taken by the mixer
+    std::atomic<FMODChainSet *>  m_retired;     // list pushed by the mixer, taken and released by setSlots
+    std::atomic<FMODChainSet *>  m_published;   // what the mixer is running, for forward and slots
+    std::atomic<bool>            m_reset;       // reset requested, carried out by the mixer
+    float                       *m_scratch[2];
+    unsigned int                 m_block_size;
+};
+
+static const FMOD_CHAIN_SLOTS FMOD_Chain_NoSlots = { };
+
+FMODChainState::FMODChainState(FMOD_DSP_STATE *dsp_state)
+    : m_pending(0), m_retired(0), m_published(0), m_reset(false)
+{
+    m_host = dsp_state;
+    m_active = 0;
+    m_scratch[0] = m_scratch[1] = 0;
+    m_block_size = 0;
+}
+
+FMOD_RESULT FMODChainState::init(FMOD_DSP_STATE *dsp_state)
+{
+    FMOD_RESULT result = FMOD_DSP_GETBLOCKSIZE(dsp_state, &m_block_size);
+    if (result != FMOD_OK)
+    {
+        return result;
+    }
+    if (!m_block_size)
+    {
+        return FMOD_ERR_INTERNAL;
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+        m_scratch[i] = (float *)FMOD_DSP_ALLOC(dsp_state, m_block_size * FMOD_CHAIN_MAX_CHANNELS * sizeof(float));
+        if (!m_scratch[i])
+        {
+            return FMOD_ERR_MEMORY;
+        }
+    }
+
+    return FMOD_OK;
+}
+
+void FMODChainState::release()
+{
+    // The DSP is no longer processed, every set can go
+    releaseSet(m_pending.exchange(0));
+    releaseRetired();
+    releaseSet(m_active);
+    m_active = 0;
+    m_published = 0;
+
+    for (int i = 0; i < 2; i++)
+    {
+        if (m_scratch[i])
+        {
+            FMOD_DSP_FREE(m_host, m_scratch[i]);
+        }
+    }
+}
+
+void FMODChainState::releaseSet(FMODChainSet *set)
+{
+    if (!set)
+    {
+        return;
+    }
+
+    for (int i = 0; i < set->slots.numslots; i++)
+    {
+        if (set->slots.description[i]->release)
+        {
+            set->slots.description[i]->release(&set->state[i]);
+        }
+    }
+
+    FMOD_DSP_FREE(m_host, set);
+}
+
+void FMODChainState::releaseRetired()
+{
+    FMODChainSet *set = m_retired.exchange(0, std::memory_order_acquire);
+    while (set)
+    {
+        FMODChainSet *next = set->next;
+        releaseSet(set);
+        set = next;
+    }
+}
+
+/*
+    Mixer side, picks up a pending set and carries out a requested reset. The replaced set goes on the retired
+    list, so the mixer never has to free anything.
+*/
+FMODChainSet *FMODChainState::current()
+{
+    FMODChainSet *pending = m_pending.exchange(0, std::memory_order_acq_rel);
+    if (pending)
+    {
+        if (m_active)
+        {
+            m_active->next = m_retired.load(std::memory_order_relaxed);
+            while (!m_retired.compare_exchange_weak(m_active->next, m_active, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+        }
+        m_active = pending;
+        m_published.store(pending, std::memory_order_release);
+    }
+
+    if (m_reset.exchange(false, std::memory_order_acquire) && m_active)
+    {
+        for (int i = 0; i < m_active->slots.numslots; i++)
+        {
+            if (m_active->slots.description[i]->reset)
+            {
+                m_active->slots.description[i]->reset(&m_active->state[i]);
+            }
+        }
+    }
+
+    return m_active;
+}
+
+FMODChainSet *FMODChainState::latest() const
+{
+    FMODChainSet *set = m_pending.load(std::memory_order_acquire);
+    return set ? set : m_published.load(std::memory_order_acquire);
+}
+
+const FMOD_CHAIN_SLOTS *FMODChainState::slots() const
+{
+    FMODChainSet *set = latest();
+    return set ? &set->slots : &FMOD_Chain_NoSlots;
+}
+
+FMOD_RESULT FMODChainState::setSlots(const FMOD_CHAIN_SLOTS *slots)
+{
+    if (slots->numslots < 0 || slots->numslots > FMOD_CHAIN_MAX_SLOTS)
+    {
+        return FMOD_ERR_INVALID_PARAM;
+    }
+    for (int i = 0; i < slots->numslots; i++)
+    {
+        const FMOD_DSP_DESCRIPTION *desc = slots->description[i];
+        if (!desc || (!desc->read && !desc->process) || desc->numinputbuffers != 1 || desc->numoutputbuffers != 1)
+        {
+            return FMOD_ERR_INVALID_PARAM;
+        }
+    }
+
+    /*
+        Sets the mixer switched away from are no longer referenced
+    */
+    releaseRetired();
+
+    FMODChainSet *set = (FMODChainSet *)FMOD_DSP_ALLOC(m_host, sizeof(FMODChainSet));
+    if (!set)
+    {
+        return FMOD_ERR_MEMORY;
+    }
+    memset(set, 0, sizeof(FMODChainSet));
+
+    for (int i = 0; i < slots->numslots; i++)
+    {
+        /*
+            The hosted effect sees a copy of the host's state with its own plugindata, so FMOD_DSP_ALLOC,
+            FMOD_DSP_GETSAMPLERATE etc. behave as if it was a node of its own.
+        */
+        set->state[i] = *m_host;
+        set->state[i].plugindata = 0;
+
+        if (slots->description[i]->create)
+        {
+            FMOD_RESULT result = slots->description[i]->create(&set->state[i]);
+            if (result != FMOD_OK)
+            {
+                releaseSet(set);
+                return result;
+            }
+        }
+
+        set->slots.description[i] = slots->description[i];
+        set->slots.numslots = i + 1;
+    }
+
+    /*
+        A set the mixer has not picked up yet was never used, replace it
+    */
+    releaseSet(m_pending.exchange(set, std::memory_order_acq_rel));
+    return FMOD_OK;
+}
+
+FMOD_RESULT FMODChainState::forward(const FMOD_CHAIN_PARAMETER *param)
+{
+    FMODChainSet *set = latest();
+
+    if (!set || param->slot < 0 || param->slot >= set->slots.numslots)
+    {
+        return FMOD_ERR_INVALID_PARAM;
+    }
+
+    const FMOD_DSP_DESCRIPTION *desc = set->slots.description[param->slot];
+    FMOD_DSP_STATE *state = &set->state[param->slot];
+
+    if (param->index < 0 || param->index >= desc->numparameters || desc->paramdesc[param->index]->type != param->type)
+    {
+        return FMOD_ERR_INVALID_PARAM;
+    }
+
+    switch (param->type)
+    {
+    case FMOD_DSP_PARAMETER_TYPE_FLOAT:
+        return desc->setparameterfloat ? desc->setparameterfloat(state, param->index, param->floatvalue) : FMOD_ERR_INVALID_PARAM;
+    case FMOD_DSP_PARAMETER_TYPE_INT:
+        return desc->setparameterint ? desc->setparameterint(state, param->index, param->intvalue) : FMOD_ERR_INVALID_PARAM;
+    case FMOD_DSP_PARAMETER_TYPE_BOOL:
+        return desc->setparameterbool ? desc->setparameterbool(state, param->index, param->boolvalue) : FMOD_ERR_INVALID_PARAM;
+    case FMOD_DSP_PARAMETER_TYPE_DATA:
+        return desc->setparameterdata ? desc->setparameterdata(state, param->index, param->data, param->datalength) : FMOD_ERR_INVALID_PARAM;
+    default:
+        return FMOD_ERR_INVALID_PARAM;
+    }
+}
+
+FMOD_RESULT FMODChainState::query(FMOD_DSP_STATE *dsp_state, unsigned int length, const FMOD_DSP_BUFFER_ARRAY *inbufferarray, FMOD_DSP_BUFFER_ARRAY *outbufferarray, FMOD_BOOL inputsidle)
+{
+    FMODChainSet    *set         = current();
+    int              numslots    = set ? set->slots.numslots : 0;
+    int              channels    = inbufferarray->buffernumchannels[0];
+    FMOD_CHANNELMASK mask        = inbufferarray->bufferchannelmask[0];
+    FMOD_SPEAKERMODE speakermode = inbufferarray->speakermode;
+    bool             idle        = true;
+
+    if (channels > FMOD_CHAIN_MAX_CHANNELS)
+    {
+        return FMOD_ERR_INVALID_PARAM;
+    }
+
+    /*
+        Give every hosted effect the query it would have had as its own node, passing the channel mask
+        along the chain. The chain only goes idle when every effect agrees.
+    */
+    for (int i = 0; i < numslots; i++)
+    {
+        const FMOD_DSP_DESCRIPTION *desc = set->slots.description[i];
+        FMOD_DSP_STATE *state = &set->state[i];
+        FMOD_RESULT result = inputsidle ? FMOD_ERR_DSP_DONTPROCESS : FMOD_OK;
+
+        state->channelmask = dsp_state->channelmask;
+        state->source_speakermode = dsp_state->source_speakermode;
+
+        if (desc->process)
+        {
+            float           *nobuffer = 0;
+            int              outchannels = channels;
+            FMOD_CHANNELMASK outmask = mask;
+            FMOD_DSP_BUFFER_ARRAY in = { 1, &channels, &mask, &nobuffer, speakermode };
+            FMOD_DSP_BUFFER_ARRAY out = { 1, &outchannels, &outmask, &nobuffer, speakermode };
+
+            result = desc->process(state, length, &in, &out, inputsidle, FMOD_DSP_PROCESS_QUERY);
+            if (result != FMOD_OK && result != FMOD_ERR_DSP_DONTPROCESS)
+            {
+                return result;
+            }
+            if (outchannels != channels)
+            {
+                return FMOD_ERR_INVALID_PARAM;
+            }
+
+            mask = outmask;
+            speakermode = out.speakermode;
+        }
+        else if (desc->shouldiprocess)
+        {
+            result = desc->shouldiprocess(state, inputsidle, length, mask, channels, speakermode);
+        }
+
+        if (result == FMOD_OK)
+        {
+            idle = false;
+        }
+    }
+
+    if (outbufferarray)
+    {
+        outbufferarray->buffernumchannels[0] = channels;
+        outbufferarray->bufferchannelmask[0] = mask;
+        outbufferarray->speakermode = speakermode;
+    }
+
+    if (inputsidle && idle)
+    {
+        return FMOD_ERR_DSP_DONTPROCESS;
+    }
+
+    return FMOD_OK;
+}
+
+FMOD_RESULT FMODChainState::runSlot(FMODChainSet *set, int slot, float *inbuffer, float *outbuffer, unsigned int length, int channels, FMOD_CHANNELMASK mask, FMOD_SPEAKERMODE speakermode, FMOD_BOOL inputsidle)
+{
+    const FMOD_DSP_DESCRIPTION *desc = set->slots.description[slot];
+    FMOD_DSP_STATE *state = &set->state[slot];
+
+    if (desc->process)
+    {
+        int              outchannels = channels;
+        FMOD_CHANNELMASK outmask = mask;
+        FMOD_DSP_BUFFER_ARRAY in = { 1, &channels, &mask, &inbuffer, speakermode };
+        FMOD_DSP_BUFFER_ARRAY out = { 1, &outchannels, &outmask, &outbuffer, speakermode };
+
+        return desc->process(state, length, &in, &out, inputsidle, FMOD_DSP_PROCESS_PERFORM);
+    }
+
+    int outchannels = channels;
+    return desc->read(state, inbuffer, outbuffer, length, channels, &outchannels);
+}
+
+FMOD_RESULT FMODChainState::process(unsigned int length, const FMOD_DSP_BUFFER_ARRAY *inbufferarray, FMOD_DSP_BUFFER_ARRAY *outbufferarray, FMOD_BOOL inputsidle)
+{
+    FMODChainSet    *set         = current();
+    float           *inbuffer    = inbufferarray->buffers[0];
+    float           *outbuffer   = outbufferarray->buffers[0];
+    int              channels    = inbufferarray->buffernumchannels[0];
+    FMOD_CHANNELMASK mask        = inbufferarray->bufferchannelmask[0];
+    FMOD_SPEAKERMODE speakermode = inbufferarray->speakermode;
+
+    if (!set || !set->slots.numslots)
+    {
+        memcpy(outbuffer, inbuffer, length * channels * sizeof(float));
+        return FMOD_OK;
+    }
+
+    /*
+        First effect reads the input, last effect writes the output, everything in between ping pongs
+        between the two scratch blocks. Blocks longer than the scratch blocks are run in pieces.
+    */
+    while (length)
+    {
+        unsigned int chunk = (length < m_block_size) ? length : m_block_size;
+
+        float *src = inbuffer;
+        for (int i = 0; i < set->slots.numslots; i++)
+        {
+            float *dst = (i == set->slots.numslots - 1) ? outbuffer : m_scratch[i & 1];
+
+            FMOD_RESULT result = runSlot(set, i, src, dst, chunk, channels, mask, speakermode, inputsidle);
+            if (result != FMOD_OK)
+            {
+                return result;
+            }
+
+            src = dst;
+        }
+
+        inbuffer  += chunk * channels;
+        outbuffer += chunk * channels;
+        length    -= chunk;
+    }
+
+    return FMOD_OK;
+}
+
+/*
+    Can be called from the API thread, so the hosted effects are reset by the mixer before its next query or process
+*/
+void FMODChainState::reset()
+{
+    m_reset.store(true, std::memory_order_release);
+}
+
+FMOD_RESULT F_CALL FMOD_Chain_dspcreate(FMOD_DSP_STATE *dsp_state)
+{
+    void *mem = FMOD_DSP_ALLOC(dsp_state, sizeof(FMODChainState));
+    if (!mem)
+    {
+        return FMOD_ERR_MEMORY;
+    }
+
+    FMODChainState *state = new (mem) FMODChainState(dsp_state);
+    dsp_state->plugindata = state;
+
+    FMOD_RESULT result = state->init(dsp_state);
+    if (result != FMOD_OK)
+    {
+        state->release();
+        FMOD_DSP_FREE(dsp_state, state);
+        dsp_state->plugindata = 0;
+    }
+    return result;
+}
+
+FMOD_RESULT F_CALL FMOD_Chain_dsprelease(FMOD_DSP_STATE *dsp_state)
+{
+    FMODChainState *state = (FMODChainState *)dsp_state->plugindata;
+    state->release();
+    FMOD_DSP_FREE(dsp_state, state);
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL FMOD_Chain_dspprocess(FMOD_DSP_STATE *dsp_state, unsigned int length, const FMOD_DSP_BUFFER_ARRAY *inbufferarray, FMOD_DSP_BUFFER_ARRAY *outbufferarray, FMOD_BOOL inputsidle, FMOD_DSP_PROCESS_OPERATION op)
+{
+    FMODChainState *state = (FMODChainState *)dsp_state->plugindata;
+
+    if (op == FMOD_DSP_PROCESS_QUERY)
+    {
+        return state->query(dsp_state, length, inbufferarray, outbufferarray, inputsidle);
+    }
+
+    return state->process(length, inbufferarray, outbufferarray, inputsidle);
+}
+
+FMOD_RESULT F_CALL FMOD_Chain_dspreset(FMOD_DSP_STATE *dsp_state)
+{
+    FMODChainState *state = (FMODChainState *)dsp_state->plugindata;
+    state->reset();
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL FMOD_Chain_dspsetparamdata(FMOD_DSP_STATE *dsp_state, int index, void *data, unsigned int length)
+{
+    FMODChainState *state = (FMODChainState *)dsp_state->plugindata;
+
+    switch (index)
+    {
+    case FMOD_CHAIN_PARAM_SLOTS:
+        if (length != sizeof(FMOD_CHAIN_SLOTS))
+        {
+            return FMOD_ERR_INVALID_PARAM;
+        }
+        return state->setSlots((const FMOD_CHAIN_SLOTS *)data);
+
+    case FMOD_CHAIN_PARAM_FORWARD:
+        if (length != sizeof(FMOD_CHAIN_PARAMETER))
+        {
+            return FMOD_ERR_INVALID_PARAM;
+        }
+        return state->forward((const FMOD_CHAIN_PARAMETER *)data);
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
+
+FMOD_RESULT F_CALL FMOD_Chain_dspgetparamdata(FMOD_DSP_STATE *dsp_state, int index, void **value, unsigned int *length, char *valuestr)
+{
+    FMODChainState *state = (FMODChainState *)dsp_state->plugindata;
+
+    switch (index)
+    {
+    case FMOD_CHAIN_PARAM_SLOTS:
+        *value = (void *)state->slots();
+        *length = sizeof(FMOD_CHAIN_SLOTS);
+        if (valuestr) snprintf(valuestr, FMOD_DSP_GETPARAM_VALUESTR_LENGTH, "%d effects", state->slots()->numslots);
+        return FMOD_OK;
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
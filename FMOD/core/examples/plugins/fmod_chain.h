@@ -0,0 +1,48 @@
+/*==============================================================================
+Effect Chain DSP Plugin Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+Parameter structures shared between the effect chain plugin and the
+application driving it.
+==============================================================================*/
+#ifndef FMOD_CHAIN_H
+#define FMOD_CHAIN_H
+
+#include "fmod_dsp.h"
+
+#define FMOD_CHAIN_MAX_SLOTS     8
+#define FMOD_CHAIN_MAX_CHANNELS  8
+
+enum
+{
+    FMOD_CHAIN_PARAM_SLOTS = 0,     /* (Data) FMOD_CHAIN_SLOTS. Can be set at any time, takes effect from the next mix. */
+    FMOD_CHAIN_PARAM_FORWARD,       /* (Data) FMOD_CHAIN_PARAMETER. Sets a parameter on one of the hosted effects. */
+    FMOD_CHAIN_NUM_PARAMETERS
+};
+
+/*
+    The effects to run, in processing order. Descriptions can come from System::getDSPInfoByPlugin or be
+    user created, they must stay valid for the lifetime of the chain DSP.
+*/
+typedef struct FMOD_CHAIN_SLOTS
+{
+    int                          numslots;
+    const FMOD_DSP_DESCRIPTION  *description[FMOD_CHAIN_MAX_SLOTS];
+} FMOD_CHAIN_SLOTS;
+
+/*
+    Addresses parameter 'index' of the effect in 'slot'. Only the value field matching 'type' is used.
+*/
+typedef struct FMOD_CHAIN_PARAMETER
+{
+    int                          slot;
+    int                          index;
+    FMOD_DSP_PARAMETER_TYPE      type;
+    float                        floatvalue;
+    int                          intvalue;
+    FMOD_BOOL                    boolvalue;
+    void                        *data;
+    unsigned int                 datalength;
+} FMOD_CHAIN_PARAMETER;
+
+#endif
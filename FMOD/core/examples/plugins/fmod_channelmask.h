@@ -0,0 +1,38 @@
+/*==============================================================================
+Channel Mask Helpers for the DSP Plugin Examples
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+Shared by the plugins that skip channels carrying no signal.
+==============================================================================*/
+#ifndef FMOD_CHANNELMASK_H
+#define FMOD_CHANNELMASK_H
+
+#include "fmod_common.h"
+
+/*
+    Maps an interleaved channel index to its FMOD_CHANNELMASK speaker bit for the given speaker mode.
+    Returns 0 when the channel has no speaker bit (raw layouts, height speakers), those channels are always processed.
+*/
+static inline FMOD_CHANNELMASK FMOD_Plugin_channelbit(FMOD_SPEAKERMODE speakermode, int channel)
+{
+    static const FMOD_CHANNELMASK quad[]     = { FMOD_CHANNELMASK_FRONT_LEFT, FMOD_CHANNELMASK_FRONT_RIGHT, FMOD_CHANNELMASK_SURROUND_LEFT, FMOD_CHANNELMASK_SURROUND_RIGHT };
+    static const FMOD_CHANNELMASK surround[] = { FMOD_CHANNELMASK_FRONT_LEFT, FMOD_CHANNELMASK_FRONT_RIGHT, FMOD_CHANNELMASK_FRONT_CENTER, FMOD_CHANNELMASK_SURROUND_LEFT, FMOD_CHANNELMASK_SURROUND_RIGHT };
+
+    switch (speakermode)
+    {
+    case FMOD_SPEAKERMODE_MONO:
+    case FMOD_SPEAKERMODE_STEREO:
+    case FMOD_SPEAKERMODE_5POINT1:
+    case FMOD_SPEAKERMODE_7POINT1:
+    case FMOD_SPEAKERMODE_7POINT1POINT4:
+        return (channel < 8) ? (1 << channel) : 0;
+    case FMOD_SPEAKERMODE_QUAD:
+        return (channel < 4) ? quad[channel] : 0;
+    case FMOD_SPEAKERMODE_SURROUND:
+        return (channel < 5) ? surround[channel] : 0;
+    default:
+        return 0;
+    }
+}
+
+#endif
@@ -14,6 +14,7 @@ This example shows how to create a distance filter DSP effect.
 #include <string.h>
 
 #include "fmod.hpp"
+#include "fmod_channelmask.h"
 
 extern "C" 
 {
@@ -26,19 +27,36 @@ const float FMOD_DISTANCE_FILTER_PARAM_MAX_DISTANCE_DEFAULT = 20.0f;
 const float FMOD_DISTANCE_FILTER_PARAM_BANDPASS_FREQUENCY_MIN     = 10.0f;
 const float FMOD_DISTANCE_FILTER_PARAM_BANDPASS_FREQUENCY_MAX     = 22000.0f;
 const float FMOD_DISTANCE_FILTER_PARAM_BANDPASS_FREQUENCY_DEFAULT = 1500.0f;
+const float FMOD_DISTANCE_FILTER_PARAM_LOD_DISTANCE_MIN     = 0.0f;
+const float FMOD_DISTANCE_FILTER_PARAM_LOD_DISTANCE_MAX     = 10000.0f;
+const float FMOD_DISTANCE_FILTER_PARAM_LOD_DISTANCE_DEFAULT = 0.0f;
+
+#define FMOD_DISTANCE_FILTER_LOD_HYSTERESIS     0.9f    /* Moving to a closer tier needs the distance 10% inside the tier boundary */
+#define FMOD_DISTANCE_FILTER_LOD_UPDATE_BLOCKS  4       /* The lowest tier only picks up new coefficients every Nth block */
 
 enum
 {
     FMOD_DISTANCE_FILTER_MAX_DISTANCE,
     FMOD_DISTANCE_FILTER_BANDPASS_FREQUENCY,
     FMOD_DISTANCE_FILTER_3D_ATTRIBUTES,
+    FMOD_DISTANCE_FILTER_LOD_DISTANCE,
     FMOD_DISTANCE_FILTER_NUM_PARAMETERS
 };
 
+/*
+    Level of detail tiers. With a non zero 'LOD Dist' the tier steps down at 1x, 2x and 4x that distance.
+*/
+enum
+{
+    FMOD_DISTANCE_FILTER_LOD_FULL,              /* 2 pole lowpass + highpass on every active channel */
+    FMOD_DISTANCE_FILTER_LOD_REDUCED,           /* 1 pole lowpass + highpass on every active channel */
+    FMOD_DISTANCE_FILTER_LOD_MONO,              /* 1 pole lowpass + highpass on the mono sum, spread back over the active channels at their own levels */
+    FMOD_DISTANCE_FILTER_LOD_MONO_DECIMATED     /* As above, coefficients only updated every FMOD_DISTANCE_FILTER_LOD_UPDATE_BLOCKS blocks */
+};
+
 FMOD_RESULT F_CALL FMOD_DistanceFilter_dspcreate       (FMOD_DSP_STATE *dsp_state);
 FMOD_RESULT F_CALL FMOD_DistanceFilter_dsprelease      (FMOD_DSP_STATE *dsp_state);
 FMOD_RESULT F_CALL FMOD_DistanceFilter_dspreset        (FMOD_DSP_STATE *dsp_state);
-FMOD_RESULT F_CALL FMOD_DistanceFilter_dspread         (FMOD_DSP_STATE *dsp_state, float *inbuffer, float *outbuffer, unsigned int length, int inchannels, int *outchannels);
 FMOD_RESULT F_CALL FMOD_DistanceFilter_dspprocess      (FMOD_DSP_STATE *dsp_state, unsigned int length, const FMOD_DSP_BUFFER_ARRAY *inbufferarray, FMOD_DSP_BUFFER_ARRAY *outbufferarray, FMOD_BOOL inputsidle, FMOD_DSP_PROCESS_OPERATION op);
 FMOD_RESULT F_CALL FMOD_DistanceFilter_dspsetparamfloat(FMOD_DSP_STATE *dsp_state, int index, float value);
 FMOD_RESULT F_CALL FMOD_DistanceFilter_dspsetparamint  (FMOD_DSP_STATE *dsp_state, int index, int value);
@@ -48,17 +66,18 @@ FMOD_RESULT F_CALL FMOD_DistanceFilter_dspgetparamfloat(FMOD_DSP_STATE *dsp_stat
 FMOD_RESULT F_CALL FMOD_DistanceFilter_dspgetparamint  (FMOD_DSP_STATE *dsp_state, int index, int *value, char *valuestr);
 FMOD_RESULT F_CALL FMOD_DistanceFilter_dspgetparambool (FMOD_DSP_STATE *dsp_state, int index, FMOD_BOOL *value, char *valuestr);
 FMOD_RESULT F_CALL FMOD_DistanceFilter_dspgetparamdata (FMOD_DSP_STATE *dsp_state, int index, void **value, unsigned int *length, char *valuestr);
-FMOD_RESULT F_CALL FMOD_DistanceFilter_shouldiprocess  (FMOD_DSP_STATE *dsp_state, FMOD_BOOL inputsidle, unsigned int length, FMOD_CHANNELMASK inmask, int inchannels, FMOD_SPEAKERMODE speakermode);
 
 static FMOD_DSP_PARAMETER_DESC p_max_distance;
 static FMOD_DSP_PARAMETER_DESC p_bandpass_frequency;
 static FMOD_DSP_PARAMETER_DESC p_3d_attributes;
+static FMOD_DSP_PARAMETER_DESC p_lod_distance;
 
 FMOD_DSP_PARAMETER_DESC *FMOD_DistanceFilter_dspparam[FMOD_DISTANCE_FILTER_NUM_PARAMETERS] =
 {
     &p_max_distance,
     &p_bandpass_frequency,
-    &p_3d_attributes
+    &p_3d_attributes,
+    &p_lod_distance
 };
 
 FMOD_DSP_DESCRIPTION FMOD_DistanceFilter_Desc =
@@ -71,8 +90,8 @@ FMOD_DSP_DESCRIPTION FMOD_DistanceFilter_Desc =
     FMOD_DistanceFilter_dspcreate,
     FMOD_DistanceFilter_dsprelease,
     FMOD_DistanceFilter_dspreset,
-    FMOD_DistanceFilter_dspread,
-    0,  // FMOD_DistanceFilter_dspprocess,  // *** declare this callback instead of FMOD_DistanceFilter_dspread if the plugin sets the output channel count ***
+    0,  // FMOD_DistanceFilter_dspread,     // the process callback is used so the query can pass the channel mask on
+    FMOD_DistanceFilter_dspprocess,
     0,
     FMOD_DISTANCE_FILTER_NUM_PARAMETERS,
     FMOD_DistanceFilter_dspparam,
@@ -84,7 +103,7 @@ FMOD_DSP_DESCRIPTION FMOD_DistanceFilter_Desc =
     0, // FMOD_DistanceFilter_dspgetparamint,
     0, // FMOD_DistanceFilter_dspgetparambool,
     FMOD_DistanceFilter_dspgetparamdata,
-    FMOD_DistanceFilter_shouldiprocess,
+    0,  // shouldiprocess, handled by the query in FMOD_DistanceFilter_dspprocess
     0,                                      // userdata
     0,                                      // sys_register
     0,                                      // sys_deregister
@@ -101,6 +120,7 @@ extern "C"
         FMOD_DSP_INIT_PARAMDESC_FLOAT_WITH_MAPPING(p_max_distance,       "Max Dist",      "",    "Distance at which bandpass stops narrowing. 0 to 1000000000. Default = 100", FMOD_DISTANCE_FILTER_PARAM_MAX_DISTANCE_DEFAULT, distance_mapping_values, distance_mapping_scale);
         FMOD_DSP_INIT_PARAMDESC_FLOAT(p_bandpass_frequency, "Frequency",     "Hz",  "Bandpass target frequency. 100 to 10,000Hz. Default = 2000Hz",               FMOD_DISTANCE_FILTER_PARAM_BANDPASS_FREQUENCY_MIN, FMOD_DISTANCE_FILTER_PARAM_BANDPASS_FREQUENCY_MAX, FMOD_DISTANCE_FILTER_PARAM_BANDPASS_FREQUENCY_DEFAULT);
         FMOD_DSP_INIT_PARAMDESC_DATA(p_3d_attributes,       "3D Attributes", "",    "",                                                                           FMOD_DSP_PARAMETER_DATA_TYPE_3DATTRIBUTES);
+        FMOD_DSP_INIT_PARAMDESC_FLOAT_WITH_MAPPING(p_lod_distance,       "LOD Dist",      "",    "Distance at which processing starts dropping to cheaper tiers. 0 = off. Default = 0", FMOD_DISTANCE_FILTER_PARAM_LOD_DISTANCE_DEFAULT, distance_mapping_values, distance_mapping_scale);
 
         return &FMOD_DistanceFilter_Desc;
     }
@@ -114,16 +134,27 @@ class FMODDistanceFilterState
     void        init                (FMOD_DSP_STATE *dsp_state);
     void        release             (FMOD_DSP_STATE *dsp_state);
     FMOD_RESULT process             (float *inbuffer, float *outbuffer, unsigned int length, int channels);
-    FMOD_RESULT process             (unsigned int length, const FMOD_DSP_BUFFER_ARRAY *inbufferarray, FMOD_DSP_BUFFER_ARRAY *outbufferarray, FMOD_BOOL inputsidle, FMOD_DSP_PROCESS_OPERATION op);
+    FMOD_RESULT process             (unsigned int length, const FMOD_DSP_BUFFER_ARRAY *inbufferarray, FMOD_DSP_BUFFER_ARRAY *outbufferarray, FMOD_BOOL inputsidle, FMOD_DSP_PROCESS_OPERATION op, FMOD_CHANNELMASK effectmask);
     void        reset               ();
+    void        setChannelMask      (FMOD_CHANNELMASK effectmask, FMOD_CHANNELMASK inmask, int channels, FMOD_SPEAKERMODE speakermode);
     void        setMaxDistance      (float);
     void        setBandpassFrequency(float);
     void        setDistance         (float);
+    void        setLODDistance      (float);
     float       maxDistance         () const { return m_max_distance; }
     float       bandpassFrequency   () const { return m_bandpass_frequency; }
+    float       lodDistance         () const { return m_lod_distance; }
 
   private:
     void        updateTimeConstants ();
+    int         lodTier             () const;
+    void        filterTier          (int tier, const float *inbuffer, float *outbuffer, unsigned int length, int channels, const int *active, int numactive);
+    template <int TIER>
+    void        filter              (const float *inbuffer, float *outbuffer, unsigned int length, int channels, const int *active, int numactive);
+    void        saveHistory         ();
+    void        restoreHistory      ();
+    void        seedHistory         (int fromtier, int totier, const int *active, int numactive);
+    void        updateMonoWeights   (const float *inbuffer, unsigned int length, int channels, const int *active, int numactive);
 
     float       m_max_distance;
     float       m_bandpass_frequency;
@@ -138,6 +169,22 @@ class FMODDistanceFilterState
     float      *m_previous_hp_out;
     int         m_sample_rate;
     int         m_max_channels;
+    unsigned int m_active_channels;     // bit n set = interleaved channel n carries signal and is filtered
+    float       m_jitter;
+    float       m_lod_distance;
+    int         m_lod_tier;
+    unsigned int m_block_count;
+    bool        m_coefficients_dirty;
+    float      *m_mono_weight;          // share of the mono sum each channel gets back, so the mono tiers keep the panning
+    float      *m_mono_weight_target;
+    bool        m_mono_weight_valid;
+    float      *m_saved_history;        // filter history snapshot used while crossfading between tiers
+    float       m_saved_lowpass_time_const;
+    float       m_saved_highpass_time_const;
+    int         m_saved_ramp_samples_left;
+    float       m_saved_jitter;
+    float      *m_crossfade_buffer;     // output of the outgoing tier during a tier change
+    unsigned int m_crossfade_length;
 };
 
 void FMODDistanceFilterState::init(FMOD_DSP_STATE *dsp_state)
@@ -148,10 +195,22 @@ void FMODDistanceFilterState::init(FMOD_DSP_STATE *dsp_state)
     m_max_distance = FMOD_DISTANCE_FILTER_PARAM_MAX_DISTANCE_DEFAULT;
     m_bandpass_frequency = FMOD_DISTANCE_FILTER_PARAM_BANDPASS_FREQUENCY_DEFAULT;
     m_distance = 0;
-
-    m_previous_lp1_out = (float*)FMOD_DSP_ALLOC(dsp_state, m_max_channels * sizeof(float));
-    m_previous_lp2_out = (float*)FMOD_DSP_ALLOC(dsp_state, m_max_channels * sizeof(float));
-    m_previous_hp_out = (float*)FMOD_DSP_ALLOC(dsp_state, m_max_channels * sizeof(float));
+    m_active_channels = ~0u;
+    m_jitter = (float)1E-20;
+    m_lod_distance = FMOD_DISTANCE_FILTER_PARAM_LOD_DISTANCE_DEFAULT;
+    m_lod_tier = FMOD_DISTANCE_FILTER_LOD_FULL;
+    m_block_count = 0;
+    m_coefficients_dirty = false;
+    FMOD_DSP_GETBLOCKSIZE(dsp_state, &m_crossfade_length);
+
+    // One extra history slot (index m_max_channels) holds the mono downmix filter used by the mono tiers
+    m_previous_lp1_out = (float*)FMOD_DSP_ALLOC(dsp_state, (m_max_channels + 1) * sizeof(float));
+    m_previous_lp2_out = (float*)FMOD_DSP_ALLOC(dsp_state, (m_max_channels + 1) * sizeof(float));
+    m_previous_hp_out = (float*)FMOD_DSP_ALLOC(dsp_state, (m_max_channels + 1) * sizeof(float));
+    m_mono_weight = (float*)FMOD_DSP_ALLOC(dsp_state, m_max_channels * sizeof(float));
+    m_mono_weight_target = (float*)FMOD_DSP_ALLOC(dsp_state, m_max_channels * sizeof(float));
+    m_saved_history = (float*)FMOD_DSP_ALLOC(dsp_state, (3 * (m_max_channels + 1) + m_max_channels) * sizeof(float));
+    m_crossfade_buffer = (float*)FMOD_DSP_ALLOC(dsp_state, m_crossfade_length * m_max_channels * sizeof(float));
 
     updateTimeConstants();
     reset();
@@ -162,6 +221,10 @@ void FMODDistanceFilterState::release(FMOD_DSP_STATE *dsp_state)
     FMOD_DSP_FREE(dsp_state, m_previous_lp1_out);
     FMOD_DSP_FREE(dsp_state, m_previous_lp2_out);
     FMOD_DSP_FREE(dsp_state, m_previous_hp_out);
+    FMOD_DSP_FREE(dsp_state, m_mono_weight);
+    FMOD_DSP_FREE(dsp_state, m_mono_weight_target);
+    FMOD_DSP_FREE(dsp_state, m_saved_history);
+    FMOD_DSP_FREE(dsp_state, m_crossfade_buffer);
 }
 
 FMOD_RESULT FMODDistanceFilterState::process(float *inbuffer, float *outbuffer, unsigned int length, int channels)
@@ -171,90 +234,333 @@ FMOD_RESULT FMODDistanceFilterState::process(float *inbuffer, float *outbuffer,
         return FMOD_ERR_INVALID_PARAM;
     }
 
+    /*
+        Only run the filter on channels that carry signal. A mono source upmixed into a 7.1 bus has 1-2 live
+        channels out of 8, the rest are passed through untouched.
+    */
+    int active[FMOD_MAX_CHANNEL_WIDTH];
+    int numactive = 0;
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        if (m_active_channels & (1u << ch))
+        {
+            active[numactive++] = ch;
+        }
+    }
+
+    if (numactive < channels && outbuffer != inbuffer)
+    {
+        memcpy(outbuffer, inbuffer, length * channels * sizeof(float));
+    }
+
+    int tier = lodTier();
+
+    if (m_coefficients_dirty && (tier != FMOD_DISTANCE_FILTER_LOD_MONO_DECIMATED || (m_block_count % FMOD_DISTANCE_FILTER_LOD_UPDATE_BLOCKS) == 0))
+    {
+        updateTimeConstants();
+        m_coefficients_dirty = false;
+    }
+    m_block_count++;
+
+    if (!numactive)
+    {
+        m_lod_tier = tier;
+        return FMOD_OK;
+    }
+
+    if (tier >= FMOD_DISTANCE_FILTER_LOD_MONO || m_lod_tier >= FMOD_DISTANCE_FILTER_LOD_MONO)
+    {
+        updateMonoWeights(inbuffer, length, channels, active, numactive);
+    }
+
+    unsigned int done = 0;
+    if (tier != m_lod_tier)
+    {
+        /*
+            Tier change. Run the outgoing tier into a scratch buffer, rewind the filter history and run the
+            incoming tier into the output, then crossfade so the switch can't be heard. The fade covers at most
+            one scratch buffer, the rest of a longer block runs on the incoming tier.
+        */
+        unsigned int fadelength = (length < m_crossfade_length) ? length : m_crossfade_length;
+
+        saveHistory();
+        filterTier(m_lod_tier, inbuffer, m_crossfade_buffer, fadelength, channels, active, numactive);
+        restoreHistory();
+        seedHistory(m_lod_tier, tier, active, numactive);
+        filterTier(tier, inbuffer, outbuffer, fadelength, channels, active, numactive);
+
+        float step = 1.0f / fadelength;
+        for (unsigned int s = 0; s < fadelength; ++s)
+        {
+            float fade = (s + 1) * step;
+            for (int i = 0; i < numactive; ++i)
+            {
+                unsigned int index = s * channels + active[i];
+                outbuffer[index] = m_crossfade_buffer[index] + fade * (outbuffer[index] - m_crossfade_buffer[index]);
+            }
+        }
+
+        done = fadelength;
+    }
+
+    if (done < length)
+    {
+        filterTier(tier, inbuffer + done * channels, outbuffer + done * channels, length - done, channels, active, numactive);
+    }
+
+    m_lod_tier = tier;
+
+    return FMOD_OK;
+}
+
+void FMODDistanceFilterState::filterTier(int tier, const float *inbuffer, float *outbuffer, unsigned int length, int channels, const int *active, int numactive)
+{
+    switch (tier)
+    {
+    case FMOD_DISTANCE_FILTER_LOD_FULL:
+        filter<FMOD_DISTANCE_FILTER_LOD_FULL>(inbuffer, outbuffer, length, channels, active, numactive);
+        break;
+    case FMOD_DISTANCE_FILTER_LOD_REDUCED:
+        filter<FMOD_DISTANCE_FILTER_LOD_REDUCED>(inbuffer, outbuffer, length, channels, active, numactive);
+        break;
+    default:
+        filter<FMOD_DISTANCE_FILTER_LOD_MONO>(inbuffer, outbuffer, length, channels, active, numactive);
+        break;
+    }
+}
+
+template <int TIER>
+void FMODDistanceFilterState::filter(const float *inbuffer, float *outbuffer, unsigned int length, int channels, const int *active, int numactive)
+{
     // Note: buffers are interleaved
-    static float jitter = (float)1E-20;
+    float jitter = m_jitter;
     float lp1_out, lp2_out;
-    int ch;
+    int ch, i;
 
     float lp_tc = m_current_lowpass_time_const;
     float hp_tc = m_current_highpass_time_const;
+    float lp_delta = 0.0f;
+    float hp_delta = 0.0f;
 
     if (m_ramp_samples_left)
     {
-        float lp_delta = (m_target_lowpass_time_const - m_current_lowpass_time_const) / m_ramp_samples_left;
-        float hp_delta = (m_target_highpass_time_const - m_current_highpass_time_const) / m_ramp_samples_left;
-        while (length)
+        lp_delta = (m_target_lowpass_time_const - m_current_lowpass_time_const) / m_ramp_samples_left;
+        hp_delta = (m_target_highpass_time_const - m_current_highpass_time_const) / m_ramp_samples_left;
+    }
+
+    float weight_delta[FMOD_MAX_CHANNEL_WIDTH];
+    if (TIER >= FMOD_DISTANCE_FILTER_LOD_MONO)
+    {
+        for (i = 0; i < numactive; ++i)
+        {
+            weight_delta[i] = (m_mono_weight_target[active[i]] - m_mono_weight[active[i]]) / length;
+        }
+    }
+
+    while (length--)
+    {
+        if (m_ramp_samples_left)
         {
             if (--m_ramp_samples_left)
             {
                 lp_tc += lp_delta;
                 hp_tc += hp_delta;
-                for (ch = 0; ch < channels; ++ch)
-                {
-                    lp1_out = m_previous_lp1_out[ch] + lp_tc * (*inbuffer++ + jitter - m_previous_lp1_out[ch]);
-                    lp2_out = m_previous_lp2_out[ch] + lp_tc * (lp1_out - m_previous_lp2_out[ch]);
-                    *outbuffer = hp_tc * (m_previous_hp_out[ch] + lp2_out - m_previous_lp2_out[ch]);
-
-                    m_previous_lp1_out[ch] = lp1_out;
-                    m_previous_lp2_out[ch] = lp2_out;
-                    m_previous_hp_out[ch] = *outbuffer++;
-                }
-                jitter = -jitter;
             }
             else
             {
                 lp_tc = m_target_lowpass_time_const;
                 hp_tc = m_target_highpass_time_const;
-                break;
             }
-            --length;
         }
-    }
 
-    while (length--)
-    {
-        for (ch = 0; ch < channels; ++ch)
+        if (TIER >= FMOD_DISTANCE_FILTER_LOD_MONO)
         {
-            lp1_out = m_previous_lp1_out[ch] + lp_tc * (*inbuffer++ + jitter - m_previous_lp1_out[ch]);
-            lp2_out = m_previous_lp2_out[ch] + lp_tc * (lp1_out - m_previous_lp2_out[ch]);
-            *outbuffer = hp_tc * (m_previous_hp_out[ch] + lp2_out - m_previous_lp2_out[ch]);
+            float in = 0.0f;
+            for (i = 0; i < numactive; ++i)
+            {
+                in += inbuffer[active[i]];
+            }
+
+            ch = m_max_channels;
+            lp1_out = m_previous_lp1_out[ch] + lp_tc * (in + jitter - m_previous_lp1_out[ch]);
+            float out = hp_tc * (m_previous_hp_out[ch] + lp1_out - m_previous_lp2_out[ch]);
 
             m_previous_lp1_out[ch] = lp1_out;
-            m_previous_lp2_out[ch] = lp2_out;
-            m_previous_hp_out[ch] = *outbuffer++;
+            m_previous_lp2_out[ch] = lp1_out;
+            m_previous_hp_out[ch] = out;
+
+            for (i = 0; i < numactive; ++i)
+            {
+                ch = active[i];
+                m_mono_weight[ch] += weight_delta[i];
+                outbuffer[ch] = out * m_mono_weight[ch];
+            }
+        }
+        else
+        {
+            for (i = 0; i < numactive; ++i)
+            {
+                ch = active[i];
+                lp1_out = m_previous_lp1_out[ch] + lp_tc * (inbuffer[ch] + jitter - m_previous_lp1_out[ch]);
+                lp2_out = (TIER == FMOD_DISTANCE_FILTER_LOD_FULL) ? m_previous_lp2_out[ch] + lp_tc * (lp1_out - m_previous_lp2_out[ch]) : lp1_out;
+                outbuffer[ch] = hp_tc * (m_previous_hp_out[ch] + lp2_out - m_previous_lp2_out[ch]);
+
+                m_previous_lp1_out[ch] = lp1_out;
+                m_previous_lp2_out[ch] = lp2_out;
+                m_previous_hp_out[ch] = outbuffer[ch];
+            }
         }
+
+        inbuffer += channels;
+        outbuffer += channels;
         jitter = -jitter;
     }
 
+    if (TIER >= FMOD_DISTANCE_FILTER_LOD_MONO)
+    {
+        for (i = 0; i < numactive; ++i)
+        {
+            m_mono_weight[active[i]] = m_mono_weight_target[active[i]];
+        }
+    }
+
     m_current_lowpass_time_const = lp_tc;
     m_current_highpass_time_const = hp_tc;
+    m_jitter = jitter;
+}
 
-    return FMOD_OK;
+/*
+    A source panned across the speakers arrives as the same signal at a different level on each channel. The filter
+    is linear, so filtering the sum and giving each channel its share of the block's level gives the same result as
+    filtering every channel, and the panning stays where it was.
+*/
+void FMODDistanceFilterState::updateMonoWeights(const float *inbuffer, unsigned int length, int channels, const int *active, int numactive)
+{
+    float level[FMOD_MAX_CHANNEL_WIDTH];
+    float total = 0.0f;
+
+    for (int i = 0; i < numactive; ++i)
+    {
+        level[i] = 0.0f;
+        for (unsigned int s = 0; s < length; ++s)
+        {
+            level[i] += fabsf(inbuffer[s * channels + active[i]]);
+        }
+        total += level[i];
+    }
+
+    if (total <= 0.0f)
+    {
+        return;     // Silent block, keep the last weights
+    }
+
+    for (int i = 0; i < numactive; ++i)
+    {
+        m_mono_weight_target[active[i]] = level[i] / total;
+        if (!m_mono_weight_valid)
+        {
+            m_mono_weight[active[i]] = m_mono_weight_target[active[i]];
+        }
+    }
+    m_mono_weight_valid = true;
 }
 
-FMOD_RESULT FMODDistanceFilterState::process(unsigned int length, const FMOD_DSP_BUFFER_ARRAY *inbufferarray, FMOD_DSP_BUFFER_ARRAY *outbufferarray, FMOD_BOOL inputsidle, FMOD_DSP_PROCESS_OPERATION op)
+int FMODDistanceFilterState::lodTier() const
 {
-    if (op == FMOD_DSP_PROCESS_QUERY)
+    if (m_lod_distance <= 0.0f)
+    {
+        return FMOD_DISTANCE_FILTER_LOD_FULL;
+    }
+
+    // Tier boundaries sit at 1x, 2x and 4x the LOD distance
+    int tier = FMOD_DISTANCE_FILTER_LOD_FULL;
+    float boundary = m_lod_distance;
+    while (tier < FMOD_DISTANCE_FILTER_LOD_MONO_DECIMATED && m_distance >= boundary)
+    {
+        tier++;
+        boundary *= 2.0f;
+    }
+
+    // Don't flap between tiers when an emitter hovers on a boundary
+    if (tier < m_lod_tier)
     {
-        FMOD_SPEAKERMODE outmode;
-        int outchannels;
+        float closer_boundary = m_lod_distance * (float)(1 << tier);
+        if (m_distance > closer_boundary * FMOD_DISTANCE_FILTER_LOD_HYSTERESIS)
+        {
+            tier++;
+        }
+    }
 
-        #if 1 // For stereo output
+    return tier;
+}
+
+void FMODDistanceFilterState::saveHistory()
+{
+    int slots = m_max_channels + 1;
+    memcpy(m_saved_history,             m_previous_lp1_out, slots * sizeof(float));
+    memcpy(m_saved_history + slots,     m_previous_lp2_out, slots * sizeof(float));
+    memcpy(m_saved_history + 2 * slots, m_previous_hp_out,  slots * sizeof(float));
+    memcpy(m_saved_history + 3 * slots, m_mono_weight,      m_max_channels * sizeof(float));
+    m_saved_lowpass_time_const = m_current_lowpass_time_const;
+    m_saved_highpass_time_const = m_current_highpass_time_const;
+    m_saved_ramp_samples_left = m_ramp_samples_left;
+    m_saved_jitter = m_jitter;
+}
+
+void FMODDistanceFilterState::restoreHistory()
+{
+    int slots = m_max_channels + 1;
+    memcpy(m_previous_lp1_out, m_saved_history,             slots * sizeof(float));
+    memcpy(m_previous_lp2_out, m_saved_history + slots,     slots * sizeof(float));
+    memcpy(m_previous_hp_out,  m_saved_history + 2 * slots, slots * sizeof(float));
+    memcpy(m_mono_weight,      m_saved_history + 3 * slots, m_max_channels * sizeof(float));
+    m_current_lowpass_time_const = m_saved_lowpass_time_const;
+    m_current_highpass_time_const = m_saved_highpass_time_const;
+    m_ramp_samples_left = m_saved_ramp_samples_left;
+    m_jitter = m_saved_jitter;
+}
+
+void FMODDistanceFilterState::seedHistory(int fromtier, int totier, const int *active, int numactive)
+{
+    int mono = m_max_channels;
+
+    if (fromtier < FMOD_DISTANCE_FILTER_LOD_MONO && totier >= FMOD_DISTANCE_FILTER_LOD_MONO)
+    {
+        // The mono filter runs on the sum, start it from the sum of the per channel filters
+        float lp1 = 0.0f, lp2 = 0.0f, hp = 0.0f;
+        for (int i = 0; i < numactive; ++i)
         {
-            outmode = FMOD_SPEAKERMODE_STEREO;
-            outchannels = 2;
+            lp1 += m_previous_lp1_out[active[i]];
+            lp2 += m_previous_lp2_out[active[i]];
+            hp += m_previous_hp_out[active[i]];
         }
-        #else // For 5.1 output
+        m_previous_lp1_out[mono] = lp1;
+        m_previous_lp2_out[mono] = lp2;
+        m_previous_hp_out[mono] = hp;
+    }
+    else if (fromtier >= FMOD_DISTANCE_FILTER_LOD_MONO && totier < FMOD_DISTANCE_FILTER_LOD_MONO)
+    {
+        for (int i = 0; i < numactive; ++i)
         {
-            outmode = FMOD_SPEAKERMODE_5POINT1;
-            outchannels = 6;
+            float weight = m_mono_weight[active[i]];
+            m_previous_lp1_out[active[i]] = m_previous_lp1_out[mono] * weight;
+            m_previous_lp2_out[active[i]] = m_previous_lp2_out[mono] * weight;
+            m_previous_hp_out[active[i]] = m_previous_hp_out[mono] * weight;
         }
-        #endif
+    }
+}
+
+FMOD_RESULT FMODDistanceFilterState::process(unsigned int length, const FMOD_DSP_BUFFER_ARRAY *inbufferarray, FMOD_DSP_BUFFER_ARRAY *outbufferarray, FMOD_BOOL inputsidle, FMOD_DSP_PROCESS_OPERATION op, FMOD_CHANNELMASK effectmask)
+{
+    if (op == FMOD_DSP_PROCESS_QUERY)
+    {
+        FMOD_CHANNELMASK inmask = inbufferarray[0].bufferchannelmask[0];
 
         if (outbufferarray)
         {
-            outbufferarray->speakermode = outmode;
-            outbufferarray->buffernumchannels[0] = outchannels;
+            outbufferarray[0].buffernumchannels[0] = inbufferarray[0].buffernumchannels[0];
+            outbufferarray[0].speakermode          = inbufferarray[0].speakermode;
+            outbufferarray[0].bufferchannelmask[0] = inmask;   // the filter never moves signal between channels, so silent channels stay silent
         }
 
         if (inputsidle)
@@ -262,21 +568,11 @@ FMOD_RESULT FMODDistanceFilterState::process(unsigned int length, const FMOD_DSP
             return FMOD_ERR_DSP_DONTPROCESS;
         }
 
+        setChannelMask(effectmask, inmask, inbufferarray[0].buffernumchannels[0], inbufferarray[0].speakermode);
         return FMOD_OK;
     }
 
-    // Do processing here
-    float *inbuffer    = inbufferarray->buffers[0];
-    float *outbuffer   = outbufferarray->buffers[0];
-    int    inchannels  = inbufferarray->buffernumchannels[0];
-    int    outchannels = outbufferarray->buffernumchannels[0];
-    
-    while(length--)
-    {
-        // MAIN DSP LOOP...
-    }
-
-    return FMOD_OK;
+    return process(inbufferarray[0].buffers[0], outbufferarray[0].buffers[0], length, inbufferarray[0].buffernumchannels[0]); // input and output channels count match for this effect
 }
 
 void FMODDistanceFilterState::reset()
@@ -284,10 +580,53 @@ void FMODDistanceFilterState::reset()
     m_current_lowpass_time_const = m_target_lowpass_time_const;
     m_current_highpass_time_const = m_target_highpass_time_const;
     m_ramp_samples_left = 0;
+    m_lod_tier = lodTier();
+
+    memset(m_previous_lp1_out, 0, (m_max_channels + 1) * sizeof(float));
+    memset(m_previous_lp2_out, 0, (m_max_channels + 1) * sizeof(float));
+    memset(m_previous_hp_out, 0, (m_max_channels + 1) * sizeof(float));
+    memset(m_mono_weight, 0, m_max_channels * sizeof(float));
+    memset(m_mono_weight_target, 0, m_max_channels * sizeof(float));
+    m_mono_weight_valid = false;
+}
+
+void FMODDistanceFilterState::setChannelMask(FMOD_CHANNELMASK effectmask, FMOD_CHANNELMASK inmask, int channels, FMOD_SPEAKERMODE speakermode)
+{
+    unsigned int active = 0;
+
+    if (!inmask)
+    {
+        inmask = ~0u;       // No mask supplied, assume every channel carries signal
+    }
+    if (!effectmask)
+    {
+        effectmask = ~0u;
+    }
+
+    for (int ch = 0; ch < channels && ch < FMOD_MAX_CHANNEL_WIDTH; ++ch)
+    {
+        FMOD_CHANNELMASK bit = FMOD_Plugin_channelbit(speakermode, ch);
+        if (!bit || (bit & inmask & effectmask))
+        {
+            active |= (1u << ch);
+        }
+    }
+
+    /*
+        Channels that drop out keep whatever history they had, clear it so they start from silence when they come back.
+    */
+    unsigned int dropped = m_active_channels & ~active;
+    for (int ch = 0; ch < m_max_channels; ++ch)
+    {
+        if (dropped & (1u << ch))
+        {
+            m_previous_lp1_out[ch] = 0;
+            m_previous_lp2_out[ch] = 0;
+            m_previous_hp_out[ch] = 0;
+        }
+    }
 
-    memset(m_previous_lp1_out, 0, m_max_channels * sizeof(float));
-    memset(m_previous_lp2_out, 0, m_max_channels * sizeof(float));
-    memset(m_previous_hp_out, 0, m_max_channels * sizeof(float));
+    m_active_channels = active;
 }
 
 void FMODDistanceFilterState::setMaxDistance(float distance)
@@ -304,8 +643,14 @@ void FMODDistanceFilterState::setBandpassFrequency(float frequency)
 
 void FMODDistanceFilterState::setDistance(float distance)
 {
+    // Picked up at the start of the next block, so the lowest LOD tier can skip coefficient updates
     m_distance = distance;
-    updateTimeConstants();
+    m_coefficients_dirty = true;
+}
+
+void FMODDistanceFilterState::setLODDistance(float distance)
+{
+    m_lod_distance = distance;
 }
 
 void FMODDistanceFilterState::updateTimeConstants()
@@ -372,16 +717,10 @@ FMOD_RESULT F_CALL FMOD_DistanceFilter_dsprelease(FMOD_DSP_STATE *dsp_state)
     return FMOD_OK;
 }
 
-FMOD_RESULT F_CALL FMOD_DistanceFilter_dspread(FMOD_DSP_STATE *dsp_state, float *inbuffer, float *outbuffer, unsigned int length, int inchannels, int * /*outchannels*/)
-{
-    FMODDistanceFilterState *state = (FMODDistanceFilterState *)dsp_state->plugindata;
-    return state->process(inbuffer, outbuffer, length, inchannels); // input and output channels count match for this effect
-}
-
 FMOD_RESULT F_CALL FMOD_DistanceFilter_dspprocess(FMOD_DSP_STATE *dsp_state, unsigned int length, const FMOD_DSP_BUFFER_ARRAY *inbufferarray, FMOD_DSP_BUFFER_ARRAY *outbufferarray, FMOD_BOOL inputsidle, FMOD_DSP_PROCESS_OPERATION op)
 {
     FMODDistanceFilterState *state = (FMODDistanceFilterState *)dsp_state->plugindata;
-    return state->process(length, inbufferarray, outbufferarray, inputsidle, op); // as an example for plugins which set the output channel count
+    return state->process(length, inbufferarray, outbufferarray, inputsidle, op, dsp_state->channelmask);
 }
 
 FMOD_RESULT F_CALL FMOD_DistanceFilter_dspreset(FMOD_DSP_STATE *dsp_state)
@@ -404,6 +743,10 @@ FMOD_RESULT F_CALL FMOD_DistanceFilter_dspsetparamfloat(FMOD_DSP_STATE *dsp_stat
     case FMOD_DISTANCE_FILTER_BANDPASS_FREQUENCY:
         state->setBandpassFrequency(value);
         return FMOD_OK;
+
+    case FMOD_DISTANCE_FILTER_LOD_DISTANCE:
+        state->setLODDistance(value);
+        return FMOD_OK;
     }
 
     return FMOD_ERR_INVALID_PARAM;
@@ -424,6 +767,11 @@ FMOD_RESULT F_CALL FMOD_DistanceFilter_dspgetparamfloat(FMOD_DSP_STATE *dsp_stat
         *value = state->bandpassFrequency();
         if (valuestr) snprintf(valuestr, FMOD_DSP_GETPARAM_VALUESTR_LENGTH, "%.1f Hz", state->bandpassFrequency());
         return FMOD_OK;
+
+    case FMOD_DISTANCE_FILTER_LOD_DISTANCE:
+        *value = state->lodDistance();
+        if (valuestr) snprintf(valuestr, FMOD_DSP_GETPARAM_VALUESTR_LENGTH, state->lodDistance() > 0.0f ? "%.1f" : "Off", state->lodDistance());
+        return FMOD_OK;
     }
 
     return FMOD_ERR_INVALID_PARAM;
@@ -454,13 +802,3 @@ FMOD_RESULT F_CALL FMOD_DistanceFilter_dspgetparamdata(FMOD_DSP_STATE * /*dsp_st
 
     return FMOD_ERR_INVALID_PARAM;
 }
-
-FMOD_RESULT F_CALL FMOD_DistanceFilter_shouldiprocess(FMOD_DSP_STATE * /*dsp_state*/, FMOD_BOOL inputsidle, unsigned int /*length*/, FMOD_CHANNELMASK /*inmask*/, int /*inchannels*/, FMOD_SPEAKERMODE /*speakermode*/)
-{
-    if (inputsidle)
-    {
-        return FMOD_ERR_DSP_DONTPROCESS;
-    }
-
-    return FMOD_OK;
-}
@@ -12,8 +12,10 @@ This example shows how to create a simple gain DSP effect.
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
+#include <new>
 
 #include "fmod.hpp"
+#include "fmod_channelmask.h"
 
 #define FMOD_GAIN_USEPROCESSCALLBACK            /* FMOD plugins have 2 methods of processing data.  
                                                     1. via a 'read' callback which is compatible with FMOD Ex but limited in functionality, or 
@@ -129,6 +131,7 @@ public:
 
     void read(float *inbuffer, float *outbuffer, unsigned int length, int channels);
     void reset();
+    void setChannelMask(FMOD_CHANNELMASK effectmask, FMOD_CHANNELMASK inmask, int channels, FMOD_SPEAKERMODE speakermode);
     void setGain(float);
     void setInvert(bool);
     float gain() const { return LINEAR_TO_DECIBELS(m_invert ? -m_target_gain : m_target_gain); }
@@ -139,12 +142,14 @@ private:
     float m_current_gain;
     int   m_ramp_samples_left;
     bool  m_invert;
+    unsigned int m_active_channels;     // bit n set = interleaved channel n carries signal and is processed
 };
 
 FMODGainState::FMODGainState()
 {
     m_target_gain = DECIBELS_TO_LINEAR(FMOD_GAIN_PARAM_GAIN_DEFAULT);
     m_invert = 0;
+    m_active_channels = ~0u;
     reset();
 }
 
@@ -152,6 +157,53 @@ void FMODGainState::read(float *inbuffer, float *outbuffer, unsigned int length,
 {
     // Note: buffers are interleaved
     float gain = m_current_gain;
+    unsigned int allchannels = (channels >= 32) ? ~0u : ((1u << channels) - 1);
+
+    if ((m_active_channels & allchannels) != allchannels)
+    {
+        /*
+            Some channels are silent or outside the effect's channel mask (e.g. a mono source upmixed into a 7.1 bus).
+            Pass the whole block through, then only scale the channels that carry signal.
+        */
+        int active[FMOD_MAX_CHANNEL_WIDTH];
+        int numactive = 0;
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            if (m_active_channels & (1u << ch))
+            {
+                active[numactive++] = ch;
+            }
+        }
+
+        if (outbuffer != inbuffer)
+        {
+            memcpy(outbuffer, inbuffer, length * channels * sizeof(float));
+        }
+
+        for (unsigned int s = 0; s < length; ++s)
+        {
+            if (m_ramp_samples_left)
+            {
+                if (--m_ramp_samples_left)
+                {
+                    gain += (m_target_gain - gain) / (m_ramp_samples_left + 1);
+                }
+                else
+                {
+                    gain = m_target_gain;
+                }
+            }
+
+            float *frame = outbuffer + s * channels;
+            for (int i = 0; i < numactive; ++i)
+            {
+                frame[active[i]] *= gain;
+            }
+        }
+
+        m_current_gain = gain;
+        return;
+    }
 
     if (m_ramp_samples_left)
     {
@@ -191,6 +243,31 @@ void FMODGainState::reset()
     m_ramp_samples_left = 0;
 }
 
+void FMODGainState::setChannelMask(FMOD_CHANNELMASK effectmask, FMOD_CHANNELMASK inmask, int channels, FMOD_SPEAKERMODE speakermode)
+{
+    unsigned int active = 0;
+
+    if (!inmask)
+    {
+        inmask = ~0u;       // No mask supplied, assume every channel carries signal
+    }
+    if (!effectmask)
+    {
+        effectmask = ~0u;
+    }
+
+    for (int ch = 0; ch < channels && ch < FMOD_MAX_CHANNEL_WIDTH; ++ch)
+    {
+        FMOD_CHANNELMASK bit = FMOD_Plugin_channelbit(speakermode, ch);
+        if (!bit || (bit & inmask & effectmask))
+        {
+            active |= (1u << ch);
+        }
+    }
+
+    m_active_channels = active;
+}
+
 void FMODGainState::setGain(float gain)
 {
     m_target_gain = m_invert ? -DECIBELS_TO_LINEAR(gain) : DECIBELS_TO_LINEAR(gain);
@@ -209,11 +286,12 @@ void FMODGainState::setInvert(bool invert)
 
 FMOD_RESULT F_CALL FMOD_Gain_dspcreate(FMOD_DSP_STATE *dsp_state)
 {
-    dsp_state->plugindata = (FMODGainState *)FMOD_DSP_ALLOC(dsp_state, sizeof(FMODGainState));
-    if (!dsp_state->plugindata)
+    void *mem = FMOD_DSP_ALLOC(dsp_state, sizeof(FMODGainState));
+    if (!mem)
     {
         return FMOD_ERR_MEMORY;
     }
+    dsp_state->plugindata = new (mem) FMODGainState();
     return FMOD_OK;
 }
 
@@ -234,8 +312,13 @@ FMOD_RESULT F_CALL FMOD_Gain_dspprocess(FMOD_DSP_STATE *dsp_state, unsigned int
     {
         if (outbufferarray && inbufferarray)
         {
+            FMOD_CHANNELMASK inmask = inbufferarray[0].bufferchannelmask[0];
+
             outbufferarray[0].buffernumchannels[0] = inbufferarray[0].buffernumchannels[0];
             outbufferarray[0].speakermode       = inbufferarray[0].speakermode;
+            outbufferarray[0].bufferchannelmask[0] = inmask;   // gain never moves signal between channels, so silent channels stay silent
+
+            state->setChannelMask(dsp_state->channelmask, inmask, inbufferarray[0].buffernumchannels[0], inbufferarray[0].speakermode);
         }
 
         if (inputsidle)
@@ -327,13 +410,16 @@ FMOD_RESULT F_CALL FMOD_Gain_dspgetparambool(FMOD_DSP_STATE *dsp_state, int inde
     return FMOD_ERR_INVALID_PARAM;
 }
 
-FMOD_RESULT F_CALL FMOD_Gain_shouldiprocess(FMOD_DSP_STATE * /*dsp_state*/, FMOD_BOOL inputsidle, unsigned int /*length*/, FMOD_CHANNELMASK /*inmask*/, int /*inchannels*/, FMOD_SPEAKERMODE /*speakermode*/)
+FMOD_RESULT F_CALL FMOD_Gain_shouldiprocess(FMOD_DSP_STATE *dsp_state, FMOD_BOOL inputsidle, unsigned int /*length*/, FMOD_CHANNELMASK inmask, int inchannels, FMOD_SPEAKERMODE speakermode)
 {
     if (inputsidle)
     {
         return FMOD_ERR_DSP_DONTPROCESS;
     }
 
+    FMODGainState *state = (FMODGainState *)dsp_state->plugindata;
+    state->setChannelMask(dsp_state->channelmask, inmask, inchannels, speakermode);
+
     return FMOD_OK;
 }
 
@@ -0,0 +1,722 @@
+/*==============================================================================
+Modulation Bus DSP Plugin Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how to share modulation sources between effect
+instances with the sys_mix callback.
+
+The effect is a tremolo, a gain driven by a 0 to 1 modulation signal.
+Instead of every instance running its own LFO, envelope or random source,
+sources are defined once on the bus (FMOD_MODBUS_PARAM_DEFINE on any
+instance, see fmod_modbus.h). In stage 0 of sys_mix, which runs once per
+mix for this plugin type before any instance is processed, every defined
+source renders one block into a row of a shared, 16 byte aligned table.
+Instances then only read the row of their source id.
+
+With FMOD_MODBUS_PARAM_SHARED off an instance renders a private copy of
+the same source every block instead, which is what effects without a bus
+do and is kept for comparison.
+
+The table belongs to the plugin, not to a System. Load the plugin into one
+System at a time.
+==============================================================================*/
+
+#ifdef WIN32
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <new>
+
+#include "fmod.hpp"
+#include "fmod_modbus.h"
+
+extern "C" {
+    F_EXPORT FMOD_DSP_DESCRIPTION* F_CALL FMODGetDSPDescription();
+}
+
+const float FMOD_MODBUS_PARAM_DEPTH_DEFAULT = 0.5f;
+
+#define FMOD_MODBUS_ALIGN           16      /* Row alignment in bytes */
+#define FMOD_MODBUS_DEFAULT_BLOCK   1024    /* Used when the mixer block size can't be queried */
+#define FMOD_MODBUS_TWOPI           6.283185307f
+
+FMOD_RESULT F_CALL FMOD_Modbus_dspcreate       (FMOD_DSP_STATE *dsp_state);
+FMOD_RESULT F_CALL FMOD_Modbus_dsprelease      (FMOD_DSP_STATE *dsp_state);
+FMOD_RESULT F_CALL FMOD_Modbus_dspreset        (FMOD_DSP_STATE *dsp_state);
+FMOD_RESULT F_CALL FMOD_Modbus_dspread         (FMOD_DSP_STATE *dsp_state, float *inbuffer, float *outbuffer, unsigned int length, int inchannels, int *outchannels);
+FMOD_RESULT F_CALL FMOD_Modbus_dspsetparamfloat(FMOD_DSP_STATE *dsp_state, int index, float value);
+FMOD_RESULT F_CALL FMOD_Modbus_dspsetparamint  (FMOD_DSP_STATE *dsp_state, int index, int value);
+FMOD_RESULT F_CALL FMOD_Modbus_dspsetparambool (FMOD_DSP_STATE *dsp_state, int index, FMOD_BOOL value);
+FMOD_RESULT F_CALL FMOD_Modbus_dspsetparamdata (FMOD_DSP_STATE *dsp_state, int index, void *data, unsigned int length);
+FMOD_RESULT F_CALL FMOD_Modbus_dspgetparamfloat(FMOD_DSP_STATE *dsp_state, int index, float *value, char *valuestr);
+FMOD_RESULT F_CALL FMOD_Modbus_dspgetparamint  (FMOD_DSP_STATE *dsp_state, int index, int *value, char *valuestr);
+FMOD_RESULT F_CALL FMOD_Modbus_dspgetparambool (FMOD_DSP_STATE *dsp_state, int index, FMOD_BOOL *value, char *valuestr);
+FMOD_RESULT F_CALL FMOD_Modbus_shouldiprocess  (FMOD_DSP_STATE *dsp_state, FMOD_BOOL inputsidle, unsigned int length, FMOD_CHANNELMASK inmask, int inchannels, FMOD_SPEAKERMODE speakermode);
+FMOD_RESULT F_CALL FMOD_Modbus_sys_register    (FMOD_DSP_STATE *dsp_state);
+FMOD_RESULT F_CALL FMOD_Modbus_sys_deregister  (FMOD_DSP_STATE *dsp_state);
+FMOD_RESULT F_CALL FMOD_Modbus_sys_mix         (FMOD_DSP_STATE *dsp_state, int stage);
+
+static FMOD_DSP_PARAMETER_DESC p_source;
+static FMOD_DSP_PARAMETER_DESC p_depth;
+static FMOD_DSP_PARAMETER_DESC p_shared;
+static FMOD_DSP_PARAMETER_DESC p_define;
+
+FMOD_DSP_PARAMETER_DESC *FMOD_Modbus_dspparam[FMOD_MODBUS_NUM_PARAMETERS] =
+{
+    &p_source,
+    &p_depth,
+    &p_shared,
+    &p_define
+};
+
+FMOD_DSP_DESCRIPTION FMOD_Modbus_Desc =
+{
+    FMOD_PLUGIN_SDK_VERSION,
+    "FMOD Modulation Bus",                  // name
+    0x00010000,                             // plugin version
+    1,                                      // number of input buffers to process
+    1,                                      // number of output buffers to process
+    FMOD_Modbus_dspcreate,
+    FMOD_Modbus_dsprelease,
+    FMOD_Modbus_dspreset,
+    FMOD_Modbus_dspread,
+    0,
+    0,
+    FMOD_MODBUS_NUM_PARAMETERS,
+    FMOD_Modbus_dspparam,
+    FMOD_Modbus_dspsetparamfloat,
+    FMOD_Modbus_dspsetparamint,
+    FMOD_Modbus_dspsetparambool,
+    FMOD_Modbus_dspsetparamdata,
+    FMOD_Modbus_dspgetparamfloat,
+    FMOD_Modbus_dspgetparamint,
+    FMOD_Modbus_dspgetparambool,
+    0, // FMOD_Modbus_dspgetparamdata,
+    FMOD_Modbus_shouldiprocess,
+    0,                                      // userdata
+    FMOD_Modbus_sys_register,
+    FMOD_Modbus_sys_deregister,
+    FMOD_Modbus_sys_mix
+};
+
+extern "C"
+{
+    F_EXPORT FMOD_DSP_DESCRIPTION* F_CALL FMODGetDSPDescription()
+    {
+        FMOD_DSP_INIT_PARAMDESC_INT(p_source, "Source", "", "Bus source id. 0 to 31. Default = 0", 0, FMOD_MODBUS_MAX_SOURCES - 1, 0, false, 0);
+        FMOD_DSP_INIT_PARAMDESC_FLOAT(p_depth, "Depth", "", "Modulation depth. 0 to 1. Default = 0.5", 0.0f, 1.0f, FMOD_MODBUS_PARAM_DEPTH_DEFAULT);
+        FMOD_DSP_INIT_PARAMDESC_BOOL(p_shared, "Shared", "", "Read the source from the bus, off renders a private copy. Default = on", true, 0);
+        FMOD_DSP_INIT_PARAMDESC_DATA(p_define, "Define", "", "FMOD_MODBUS_SOURCE, defines a bus source", FMOD_DSP_PARAMETER_DATA_TYPE_USER);
+
+        return &FMOD_Modbus_Desc;
+    }
+}
+
+/*
+    One LFO, envelope or random generator. Used by the bus for the shared rows and by instances for private copies.
+*/
+class FMODModbusSource
+{
+public:
+    FMODModbusSource();
+
+    void        define(const FMOD_MODBUS_SOURCE *source);
+    void        render(float *out, unsigned int length, float rate);
+    const FMOD_MODBUS_SOURCE &definition() const { return m_def; }
+
+private:
+    float       random();
+
+    FMOD_MODBUS_SOURCE  m_def;
+    float               m_phase;
+    float               m_level;
+    int                 m_stage;            // Envelope: 0 idle, 1 attack, 2 decay, 3 sustain, 4 release
+    float               m_target;
+    float               m_step;
+    unsigned int        m_count;
+    unsigned int        m_seed;
+};
+
+enum
+{
+    FMOD_MODBUS_STAGE_IDLE = 0,
+    FMOD_MODBUS_STAGE_ATTACK,
+    FMOD_MODBUS_STAGE_DECAY,
+    FMOD_MODBUS_STAGE_SUSTAIN,
+    FMOD_MODBUS_STAGE_RELEASE
+};
+
+FMODModbusSource::FMODModbusSource()
+{
+    memset(&m_def, 0, sizeof(m_def));
+    m_phase = 0.0f;
+    m_level = 0.0f;
+    m_stage = FMOD_MODBUS_STAGE_IDLE;
+    m_target = 0.0f;
+    m_step = 0.0f;
+    m_count = 0;
+    m_seed = 1;
+}
+
+void FMODModbusSource::define(const FMOD_MODBUS_SOURCE *source)
+{
+    if (source->type != m_def.type)
+    {
+        m_phase = 0.0f;
+        m_level = 0.0f;
+        m_stage = FMOD_MODBUS_STAGE_IDLE;
+        m_count = 0;
+        m_seed = 0x9E3779B9u * (unsigned int)(source->id + 1);   // Same sequence for the bus and every private copy
+    }
+
+    if (source->type == FMOD_MODBUS_TYPE_ENVELOPE && (source->gate != 0) != (m_def.gate != 0 && m_def.type == FMOD_MODBUS_TYPE_ENVELOPE))
+    {
+        m_stage = source->gate ? FMOD_MODBUS_STAGE_ATTACK : FMOD_MODBUS_STAGE_RELEASE;
+    }
+
+    m_def = *source;
+}
+
+float FMODModbusSource::random()
+{
+    m_seed = m_seed * 1664525u + 1013904223u;
+    return (m_seed >> 8) * (1.0f / 16777216.0f);
+}
+
+void FMODModbusSource::render(float *out, unsigned int length, float rate)
+{
+    switch (m_def.type)
+    {
+    case FMOD_MODBUS_TYPE_LFO:
+    {
+        float phase = m_phase;
+        float increment = m_def.rate / rate;
+
+        for (unsigned int s = 0; s < length; s++)
+        {
+            switch (m_def.shape)
+            {
+            case FMOD_MODBUS_SHAPE_SINE:        out[s] = 0.5f + 0.5f * sinf(FMOD_MODBUS_TWOPI * phase); break;
+            case FMOD_MODBUS_SHAPE_TRIANGLE:    out[s] = 1.0f - fabsf(2.0f * phase - 1.0f);              break;
+            case FMOD_MODBUS_SHAPE_SQUARE:      out[s] = phase < 0.5f ? 1.0f : 0.0f;                    break;
+            default:                            out[s] = phase;                                         break;
+            }
+
+            phase += increment;
+            if (phase >= 1.0f)
+            {
+                phase -= 1.0f;
+            }
+        }
+
+        m_phase = phase;
+        break;
+    }
+    case FMOD_MODBUS_TYPE_ENVELOPE:
+    {
+        float attack  = 1.0f / (rate * (m_def.attack > 0.001f ? m_def.attack : 0.001f));
+        float decay   = 1.0f / (rate * (m_def.decay > 0.001f ? m_def.decay : 0.001f));
+        float release = 1.0f / (rate * (m_def.release > 0.001f ? m_def.release : 0.001f));
+
+        for (unsigned int s = 0; s < length; s++)
+        {
+            switch (m_stage)
+            {
+            case FMOD_MODBUS_STAGE_ATTACK:
+                m_level += attack;
+                if (m_level >= 1.0f)
+                {
+                    m_level = 1.0f;
+                    m_stage = FMOD_MODBUS_STAGE_DECAY;
+                }
+                break;
+            case FMOD_MODBUS_STAGE_DECAY:
+                m_level -= decay;
+                if (m_level <= m_def.sustain)
+                {
+                    m_level = m_def.sustain;
+                    m_stage = FMOD_MODBUS_STAGE_SUSTAIN;
+                }
+                break;
+            case FMOD_MODBUS_STAGE_RELEASE:
+                m_level -= release;
+                if (m_level <= 0.0f)
+                {
+                    m_level = 0.0f;
+                    m_stage = FMOD_MODBUS_STAGE_IDLE;
+                }
+                break;
+            }
+            out[s] = m_level;
+        }
+        break;
+    }
+    case FMOD_MODBUS_TYPE_RANDOM:
+    {
+        unsigned int period = (unsigned int)(rate / (m_def.rate > 0.01f ? m_def.rate : 0.01f));
+        if (period < 1)
+        {
+            period = 1;
+        }
+
+        for (unsigned int s = 0; s < length; s++)
+        {
+            if (!m_count)
+            {
+                m_target = random();
+                m_step = (m_target - m_level) / period;
+                m_count = period;
+            }
+            m_level += m_step;
+            m_count--;
+            out[s] = m_level;
+        }
+        break;
+    }
+    default:
+        for (unsigned int s = 0; s < length; s++)
+        {
+            out[s] = 1.0f;
+        }
+        break;
+    }
+}
+
+/*
+    The bus. Definitions arrive from the API thread into 'Pending', stage 0 of sys_mix applies them on the mixer
+    thread, then renders the rows. Instances only touch the rows and the applied definitions, both on the mixer thread.
+*/
+static std::atomic<int>     FMOD_Modbus_Registered(0);
+static std::atomic_flag     FMOD_Modbus_PendingLock = ATOMIC_FLAG_INIT;
+static FMOD_MODBUS_SOURCE   FMOD_Modbus_Pending[FMOD_MODBUS_MAX_SOURCES];
+static bool                 FMOD_Modbus_PendingDirty[FMOD_MODBUS_MAX_SOURCES];
+static FMODModbusSource     FMOD_Modbus_Sources[FMOD_MODBUS_MAX_SOURCES];
+static unsigned int         FMOD_Modbus_Serial[FMOD_MODBUS_MAX_SOURCES];      // Bumped each time a definition is applied
+static void                *FMOD_Modbus_Memory = 0;
+static float               *FMOD_Modbus_Rows = 0;
+static unsigned int         FMOD_Modbus_RowLength = 0;                      // Frames, multiple of 4 so every row stays aligned
+static float                FMOD_Modbus_Rate = 48000.0f;
+
+static float *FMOD_Modbus_row(int id)
+{
+    return FMOD_Modbus_Rows + id * FMOD_Modbus_RowLength;
+}
+
+static void FMOD_Modbus_post(const FMOD_MODBUS_SOURCE *source)
+{
+    while (FMOD_Modbus_PendingLock.test_and_set(std::memory_order_acquire))
+    {
+        // The mixer only holds the lock long enough to copy the pending definitions
+    }
+    FMOD_Modbus_Pending[source->id] = *source;
+    FMOD_Modbus_PendingDirty[source->id] = true;
+    FMOD_Modbus_PendingLock.clear(std::memory_order_release);
+}
+
+static void FMOD_Modbus_apply()
+{
+    if (FMOD_Modbus_PendingLock.test_and_set(std::memory_order_acquire))
+    {
+        return;     // A definition is being posted, pick it up next mix
+    }
+
+    for (int id = 0; id < FMOD_MODBUS_MAX_SOURCES; id++)
+    {
+        if (FMOD_Modbus_PendingDirty[id])
+        {
+            FMOD_Modbus_Sources[id].define(&FMOD_Modbus_Pending[id]);
+            FMOD_Modbus_PendingDirty[id] = false;
+            FMOD_Modbus_Serial[id]++;
+
+            if (FMOD_Modbus_Pending[id].type == FMOD_MODBUS_TYPE_OFF && FMOD_Modbus_Rows)
+            {
+                FMOD_Modbus_Sources[id].render(FMOD_Modbus_row(id), FMOD_Modbus_RowLength, FMOD_Modbus_Rate);
+            }
+        }
+    }
+
+    FMOD_Modbus_PendingLock.clear(std::memory_order_release);
+}
+
+class FMODModbusState
+{
+public:
+    FMODModbusState();
+
+    FMOD_RESULT init(FMOD_DSP_STATE *dsp_state);
+    void        release(FMOD_DSP_STATE *dsp_state);
+    void        read(float *inbuffer, float *outbuffer, unsigned int length, int channels);
+    void        reset();
+    void        setSource(int source)   { m_source = source; m_serial = ~0u; }
+    void        setDepth(float depth)   { m_depth = depth; }
+    void        setShared(bool shared)  { m_shared = shared; m_serial = ~0u; }
+    int         source() const          { return m_source; }
+    float       depth() const           { return m_depth; }
+    FMOD_BOOL   shared() const          { return m_shared; }
+
+private:
+    void        apply(const float *mod, const float *inbuffer, float *outbuffer, unsigned int length, int channels);
+
+    int                 m_source;
+    float               m_depth;
+    bool                m_shared;
+    float               m_rate;
+    float              *m_scratch;          // Private copy output, one block
+    unsigned int        m_scratchlength;
+    FMODModbusSource    m_private;
+    unsigned int        m_serial;           // Bus definition the private copy was taken from
+};
+
+FMODModbusState::FMODModbusState()
+{
+    m_source = 0;
+    m_depth = FMOD_MODBUS_PARAM_DEPTH_DEFAULT;
+    m_shared = true;
+    m_rate = 48000.0f;
+    m_scratch = 0;
+    m_scratchlength = 0;
+    m_serial = ~0u;
+}
+
+FMOD_RESULT FMODModbusState::init(FMOD_DSP_STATE *dsp_state)
+{
+    int rate;
+    unsigned int blocksize;
+
+    FMOD_RESULT result = FMOD_DSP_GETSAMPLERATE(dsp_state, &rate);
+    if (result != FMOD_OK)
+    {
+        return result;
+    }
+    m_rate = (float)rate;
+
+    if (FMOD_DSP_GETBLOCKSIZE(dsp_state, &blocksize) != FMOD_OK || !blocksize)
+    {
+        blocksize = FMOD_MODBUS_DEFAULT_BLOCK;
+    }
+
+    m_scratch = (float *)FMOD_DSP_ALLOC(dsp_state, blocksize * sizeof(float));
+    if (!m_scratch)
+    {
+        return FMOD_ERR_MEMORY;
+    }
+    m_scratchlength = blocksize;
+
+    return FMOD_OK;
+}
+
+void FMODModbusState::release(FMOD_DSP_STATE *dsp_state)
+{
+    if (m_scratch)
+    {
+        FMOD_DSP_FREE(dsp_state, m_scratch);
+        m_scratch = 0;
+    }
+}
+
+void FMODModbusState::reset()
+{
+    m_serial = ~0u;
+}
+
+void FMODModbusState::apply(const float *mod, const float *inbuffer, float *outbuffer, unsigned int length, int channels)
+{
+    // Note: buffers are interleaved
+    float depth = m_depth;
+    float floor = 1.0f - depth;
+
+    if (channels == 2)
+    {
+        for (unsigned int s = 0; s < length; s++)
+        {
+            float gain = floor + depth * mod[s];
+            outbuffer[0] = inbuffer[0] * gain;
+            outbuffer[1] = inbuffer[1] * gain;
+            inbuffer += 2;
+            outbuffer += 2;
+        }
+        return;
+    }
+
+    for (unsigned int s = 0; s < length; s++)
+    {
+        float gain = floor + depth * mod[s];
+        for (int c = 0; c < channels; c++)
+        {
+            *outbuffer++ = *inbuffer++ * gain;
+        }
+    }
+}
+
+void FMODModbusState::read(float *inbuffer, float *outbuffer, unsigned int length, int channels)
+{
+    if (m_shared && FMOD_Modbus_Rows && length <= FMOD_Modbus_RowLength)
+    {
+        apply(FMOD_Modbus_row(m_source), inbuffer, outbuffer, length, channels);
+        return;
+    }
+
+    /*
+        Private copy. Follow the bus definition, keep our own phase.
+    */
+    if (m_serial != FMOD_Modbus_Serial[m_source])
+    {
+        m_private.define(&FMOD_Modbus_Sources[m_source].definition());
+        m_serial = FMOD_Modbus_Serial[m_source];
+    }
+
+    while (length)
+    {
+        unsigned int chunk = length < m_scratchlength ? length : m_scratchlength;
+
+        m_private.render(m_scratch, chunk, m_rate);
+        apply(m_scratch, inbuffer, outbuffer, chunk, channels);
+
+        inbuffer += chunk * channels;
+        outbuffer += chunk * channels;
+        length -= chunk;
+    }
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_dspcreate(FMOD_DSP_STATE *dsp_state)
+{
+    void *mem = FMOD_DSP_ALLOC(dsp_state, sizeof(FMODModbusState));
+    if (!mem)
+    {
+        return FMOD_ERR_MEMORY;
+    }
+
+    FMODModbusState *state = new (mem) FMODModbusState();
+    dsp_state->plugindata = state;
+
+    FMOD_RESULT result = state->init(dsp_state);
+    if (result != FMOD_OK)
+    {
+        state->release(dsp_state);
+        FMOD_DSP_FREE(dsp_state, state);
+        dsp_state->plugindata = 0;
+    }
+    return result;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_dsprelease(FMOD_DSP_STATE *dsp_state)
+{
+    FMODModbusState *state = (FMODModbusState *)dsp_state->plugindata;
+    state->release(dsp_state);
+    FMOD_DSP_FREE(dsp_state, state);
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_dspread(FMOD_DSP_STATE *dsp_state, float *inbuffer, float *outbuffer, unsigned int length, int inchannels, int * /*outchannels*/)
+{
+    FMODModbusState *state = (FMODModbusState *)dsp_state->plugindata;
+    state->read(inbuffer, outbuffer, length, inchannels); // input and output channels count match for this effect
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_dspreset(FMOD_DSP_STATE *dsp_state)
+{
+    FMODModbusState *state = (FMODModbusState *)dsp_state->plugindata;
+    state->reset();
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_dspsetparamfloat(FMOD_DSP_STATE *dsp_state, int index, float value)
+{
+    FMODModbusState *state = (FMODModbusState *)dsp_state->plugindata;
+
+    switch (index)
+    {
+    case FMOD_MODBUS_PARAM_DEPTH:
+        state->setDepth(value);
+        return FMOD_OK;
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_dspgetparamfloat(FMOD_DSP_STATE *dsp_state, int index, float *value, char *valuestr)
+{
+    FMODModbusState *state = (FMODModbusState *)dsp_state->plugindata;
+
+    switch (index)
+    {
+    case FMOD_MODBUS_PARAM_DEPTH:
+        *value = state->depth();
+        if (valuestr) snprintf(valuestr, FMOD_DSP_GETPARAM_VALUESTR_LENGTH, "%.2f", state->depth());
+        return FMOD_OK;
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_dspsetparamint(FMOD_DSP_STATE *dsp_state, int index, int value)
+{
+    FMODModbusState *state = (FMODModbusState *)dsp_state->plugindata;
+
+    switch (index)
+    {
+    case FMOD_MODBUS_PARAM_SOURCE:
+        state->setSource(value);
+        return FMOD_OK;
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_dspgetparamint(FMOD_DSP_STATE *dsp_state, int index, int *value, char *valuestr)
+{
+    FMODModbusState *state = (FMODModbusState *)dsp_state->plugindata;
+
+    switch (index)
+    {
+    case FMOD_MODBUS_PARAM_SOURCE:
+        *value = state->source();
+        if (valuestr) snprintf(valuestr, FMOD_DSP_GETPARAM_VALUESTR_LENGTH, "%d", state->source());
+        return FMOD_OK;
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_dspsetparambool(FMOD_DSP_STATE *dsp_state, int index, FMOD_BOOL value)
+{
+    FMODModbusState *state = (FMODModbusState *)dsp_state->plugindata;
+
+    switch (index)
+    {
+    case FMOD_MODBUS_PARAM_SHARED:
+        state->setShared(value ? true : false);
+        return FMOD_OK;
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_dspgetparambool(FMOD_DSP_STATE *dsp_state, int index, FMOD_BOOL *value, char *valuestr)
+{
+    FMODModbusState *state = (FMODModbusState *)dsp_state->plugindata;
+
+    switch (index)
+    {
+    case FMOD_MODBUS_PARAM_SHARED:
+        *value = state->shared();
+        if (valuestr) snprintf(valuestr, FMOD_DSP_GETPARAM_VALUESTR_LENGTH, state->shared() ? "Shared" : "Private");
+        return FMOD_OK;
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_dspsetparamdata(FMOD_DSP_STATE * /*dsp_state*/, int index, void *data, unsigned int length)
+{
+    switch (index)
+    {
+    case FMOD_MODBUS_PARAM_DEFINE:
+    {
+        const FMOD_MODBUS_SOURCE *source = (const FMOD_MODBUS_SOURCE *)data;
+        if (length != sizeof(FMOD_MODBUS_SOURCE) || source->id < 0 || source->id >= FMOD_MODBUS_MAX_SOURCES)
+        {
+            return FMOD_ERR_INVALID_PARAM;
+        }
+        FMOD_Modbus_post(source);
+        return FMOD_OK;
+    }
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_shouldiprocess(FMOD_DSP_STATE * /*dsp_state*/, FMOD_BOOL inputsidle, unsigned int /*length*/, FMOD_CHANNELMASK /*inmask*/, int /*inchannels*/, FMOD_SPEAKERMODE /*speakermode*/)
+{
+    if (inputsidle)
+    {
+        return FMOD_ERR_DSP_DONTPROCESS;
+    }
+
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_sys_register(FMOD_DSP_STATE *dsp_state)
+{
+    // called once for this type of dsp being loaded or registered (it is not per instance)
+    if (FMOD_Modbus_Registered++)
+    {
+        return FMOD_OK;
+    }
+
+    int rate;
+    unsigned int blocksize;
+
+    if (FMOD_DSP_GETSAMPLERATE(dsp_state, &rate) == FMOD_OK && rate > 0)
+    {
+        FMOD_Modbus_Rate = (float)rate;
+    }
+    if (FMOD_DSP_GETBLOCKSIZE(dsp_state, &blocksize) != FMOD_OK || !blocksize)
+    {
+        blocksize = FMOD_MODBUS_DEFAULT_BLOCK;
+    }
+
+    FMOD_Modbus_RowLength = (blocksize + 3) & ~3u;
+    FMOD_Modbus_Memory = FMOD_DSP_ALLOC(dsp_state, FMOD_MODBUS_MAX_SOURCES * FMOD_Modbus_RowLength * sizeof(float) + FMOD_MODBUS_ALIGN);
+    if (!FMOD_Modbus_Memory)
+    {
+        FMOD_Modbus_Registered--;
+        return FMOD_ERR_MEMORY;
+    }
+    FMOD_Modbus_Rows = (float *)(((size_t)FMOD_Modbus_Memory + FMOD_MODBUS_ALIGN - 1) & ~(size_t)(FMOD_MODBUS_ALIGN - 1));
+
+    for (int id = 0; id < FMOD_MODBUS_MAX_SOURCES; id++)
+    {
+        FMOD_Modbus_Sources[id] = FMODModbusSource();
+        FMOD_Modbus_Serial[id] = 0;
+        FMOD_Modbus_PendingDirty[id] = false;
+        FMOD_Modbus_Sources[id].render(FMOD_Modbus_row(id), FMOD_Modbus_RowLength, FMOD_Modbus_Rate);
+    }
+
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_sys_deregister(FMOD_DSP_STATE *dsp_state)
+{
+    // called once for this type of dsp being unloaded or de-registered (it is not per instance)
+    if (--FMOD_Modbus_Registered)
+    {
+        return FMOD_OK;
+    }
+
+    FMOD_Modbus_Rows = 0;
+    FMOD_Modbus_RowLength = 0;
+    if (FMOD_Modbus_Memory)
+    {
+        FMOD_DSP_FREE(dsp_state, FMOD_Modbus_Memory);
+        FMOD_Modbus_Memory = 0;
+    }
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL FMOD_Modbus_sys_mix(FMOD_DSP_STATE * /*dsp_state*/, int stage)
+{
+    // stage == 0 , before all dsps are processed/mixed, this callback is called once for this type.
+    // stage == 1 , after all dsps are processed/mixed, this callback is called once for this type.
+    if (stage != 0 || !FMOD_Modbus_Rows)
+    {
+        return FMOD_OK;
+    }
+
+    FMOD_Modbus_apply();
+
+    for (int id = 0; id < FMOD_MODBUS_MAX_SOURCES; id++)
+    {
+        if (FMOD_Modbus_Sources[id].definition().type != FMOD_MODBUS_TYPE_OFF)
+        {
+            FMOD_Modbus_Sources[id].render(FMOD_Modbus_row(id), FMOD_Modbus_RowLength, FMOD_Modbus_Rate);
+        }
+    }
+
+    return FMOD_OK;
+}
@@ -0,0 +1,57 @@
+/*==============================================================================
+Modulation Bus DSP Plugin Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+Parameter structures shared between the modulation bus plugin and the
+application defining its sources.
+==============================================================================*/
+#ifndef FMOD_MODBUS_H
+#define FMOD_MODBUS_H
+
+#include "fmod_dsp.h"
+
+#define FMOD_MODBUS_MAX_SOURCES  32
+
+enum
+{
+    FMOD_MODBUS_PARAM_SOURCE = 0,   /* (Int) Source id read by this instance. 0 to FMOD_MODBUS_MAX_SOURCES - 1. Default = 0 */
+    FMOD_MODBUS_PARAM_DEPTH,        /* (Float) Modulation depth. 0 to 1. Default = 0.5 */
+    FMOD_MODBUS_PARAM_SHARED,       /* (Bool) Read the source from the bus (on) or render a private copy (off). Default = on */
+    FMOD_MODBUS_PARAM_DEFINE,       /* (Data) FMOD_MODBUS_SOURCE. Defines a bus source, can be set on any instance. */
+    FMOD_MODBUS_NUM_PARAMETERS
+};
+
+typedef enum FMOD_MODBUS_TYPE
+{
+    FMOD_MODBUS_TYPE_OFF,           /* Reads as 1, the effect passes the signal through */
+    FMOD_MODBUS_TYPE_LFO,
+    FMOD_MODBUS_TYPE_ENVELOPE,
+    FMOD_MODBUS_TYPE_RANDOM,        /* Smoothed sample and hold */
+} FMOD_MODBUS_TYPE;
+
+typedef enum FMOD_MODBUS_SHAPE
+{
+    FMOD_MODBUS_SHAPE_SINE,
+    FMOD_MODBUS_SHAPE_TRIANGLE,
+    FMOD_MODBUS_SHAPE_SQUARE,
+    FMOD_MODBUS_SHAPE_SAW,
+} FMOD_MODBUS_SHAPE;
+
+/*
+    Sources output 0 to 1. Redefining a source keeps its phase and envelope level, so an envelope is driven by
+    setting it again with a different 'gate'. Times are in seconds, 'rate' is in Hz.
+*/
+typedef struct FMOD_MODBUS_SOURCE
+{
+    int                 id;
+    FMOD_MODBUS_TYPE    type;
+    FMOD_MODBUS_SHAPE   shape;          /* LFO */
+    float               rate;           /* LFO, random */
+    float               attack;         /* Envelope */
+    float               decay;          /* Envelope */
+    float               sustain;        /* Envelope, level 0 to 1 */
+    float               release;        /* Envelope */
+    FMOD_BOOL           gate;           /* Envelope */
+} FMOD_MODBUS_SOURCE;
+
+#endif
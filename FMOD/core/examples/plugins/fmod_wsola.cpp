@@ -0,0 +1,613 @@
+/*==============================================================================
+WSOLA Pitch Shift DSP Plugin Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how to create a low cost time domain pitch shifter.
+
+The input is written into a history ring and read back at 'pitch' times the
+input rate, which shifts the pitch and makes the read position drift
+towards (pitch up) or away from (pitch down) the write position. When the
+distance leaves its window the read position jumps one or more periods
+back or forward. The jump is picked WSOLA style, by searching for the
+offset whose waveform best matches what is playing now (normalized cross
+correlation on a mono downmix, SSE on x86/x64, NEON on ARM64), and the two
+positions are cross faded over a short overlap.
+
+All buffers are allocated when the DSP is created, nothing is allocated
+while processing. The 'Quality' parameter trades overlap, correlation
+length and search resolution for CPU. Latency is roughly the delay window,
+20 to 60 ms depending on quality. Works best on speech and other sources
+with a clear period, the FFT based FMOD_DSP_TYPE_PITCHSHIFT handles dense
+mixes better.
+==============================================================================*/
+
+#ifdef WIN32
+    #define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <new>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE__)
+    #include <xmmintrin.h>
+    #define FMOD_WSOLA_SSE
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    #include <arm_neon.h>
+    #define FMOD_WSOLA_NEON
+#endif
+
+#include "fmod.hpp"
+
+extern "C" {
+    F_EXPORT FMOD_DSP_DESCRIPTION* F_CALL FMODGetDSPDescription();
+}
+
+const float FMOD_WSOLA_PARAM_PITCH_MIN     = 0.5f;
+const float FMOD_WSOLA_PARAM_PITCH_MAX     = 2.0f;
+const float FMOD_WSOLA_PARAM_PITCH_DEFAULT = 1.0f;
+
+#define FMOD_WSOLA_MAX_CHANNELS     8
+#define FMOD_WSOLA_HISTORY_SECONDS  0.25f   /* Ring length, must cover the delay window plus the largest jump */
+#define FMOD_WSOLA_CHUNK            1024    /* Blocks are processed in chunks of at most this many frames */
+
+enum
+{
+    FMOD_WSOLA_PARAM_PITCH = 0,
+    FMOD_WSOLA_PARAM_QUALITY,
+    FMOD_WSOLA_NUM_PARAMETERS
+};
+
+enum
+{
+    FMOD_WSOLA_QUALITY_FAST = 0,
+    FMOD_WSOLA_QUALITY_NORMAL,
+    FMOD_WSOLA_QUALITY_HIGH,
+    FMOD_WSOLA_NUM_QUALITIES
+};
+
+/*
+    Per quality settings, in milliseconds except for the search step which is in samples. The coarse
+    search visits every 'step'th offset and is then refined around the best one.
+*/
+struct FMODWsolaQuality
+{
+    float overlapms;
+    float correlationms;
+    float searchms;
+    int   step;
+};
+
+static const FMODWsolaQuality FMOD_Wsola_Qualities[FMOD_WSOLA_NUM_QUALITIES] =
+{
+    { 5.0f,  5.0f,  10.0f, 8 },
+    { 8.0f,  8.0f,  15.0f, 4 },
+    { 12.0f, 12.0f, 20.0f, 1 },
+};
+
+FMOD_RESULT F_CALL FMOD_Wsola_dspcreate       (FMOD_DSP_STATE *dsp_state);
+FMOD_RESULT F_CALL FMOD_Wsola_dsprelease      (FMOD_DSP_STATE *dsp_state);
+FMOD_RESULT F_CALL FMOD_Wsola_dspreset        (FMOD_DSP_STATE *dsp_state);
+FMOD_RESULT F_CALL FMOD_Wsola_dspread         (FMOD_DSP_STATE *dsp_state, float *inbuffer, float *outbuffer, unsigned int length, int inchannels, int *outchannels);
+FMOD_RESULT F_CALL FMOD_Wsola_dspsetparamfloat(FMOD_DSP_STATE *dsp_state, int index, float value);
+FMOD_RESULT F_CALL FMOD_Wsola_dspsetparamint  (FMOD_DSP_STATE *dsp_state, int index, int value);
+FMOD_RESULT F_CALL FMOD_Wsola_dspgetparamfloat(FMOD_DSP_STATE *dsp_state, int index, float *value, char *valuestr);
+FMOD_RESULT F_CALL FMOD_Wsola_dspgetparamint  (FMOD_DSP_STATE *dsp_state, int index, int *value, char *valuestr);
+FMOD_RESULT F_CALL FMOD_Wsola_shouldiprocess  (FMOD_DSP_STATE *dsp_state, FMOD_BOOL inputsidle, unsigned int length, FMOD_CHANNELMASK inmask, int inchannels, FMOD_SPEAKERMODE speakermode);
+
+static FMOD_DSP_PARAMETER_DESC p_pitch;
+static FMOD_DSP_PARAMETER_DESC p_quality;
+
+FMOD_DSP_PARAMETER_DESC *FMOD_Wsola_dspparam[FMOD_WSOLA_NUM_PARAMETERS] =
+{
+    &p_pitch,
+    &p_quality
+};
+
+FMOD_DSP_DESCRIPTION FMOD_Wsola_Desc =
+{
+    FMOD_PLUGIN_SDK_VERSION,
+    "FMOD WSOLA Pitch",                     // name
+    0x00010000,                             // plugin version
+    1,                                      // number of input buffers to process
+    1,                                      // number of output buffers to process
+    FMOD_Wsola_dspcreate,
+    FMOD_Wsola_dsprelease,
+    FMOD_Wsola_dspreset,
+    FMOD_Wsola_dspread,
+    0,
+    0,
+    FMOD_WSOLA_NUM_PARAMETERS,
+    FMOD_Wsola_dspparam,
+    FMOD_Wsola_dspsetparamfloat,
+    FMOD_Wsola_dspsetparamint,
+    0, // FMOD_Wsola_dspsetparambool,
+    0, // FMOD_Wsola_dspsetparamdata,
+    FMOD_Wsola_dspgetparamfloat,
+    FMOD_Wsola_dspgetparamint,
+    0, // FMOD_Wsola_dspgetparambool,
+    0, // FMOD_Wsola_dspgetparamdata,
+    FMOD_Wsola_shouldiprocess,
+    0,                                      // userdata
+    0,                                      // sys_register
+    0,                                      // sys_deregister
+    0                                       // sys_mix
+};
+
+extern "C"
+{
+    F_EXPORT FMOD_DSP_DESCRIPTION* F_CALL FMODGetDSPDescription()
+    {
+        static const char *quality_names[] = { "Fast", "Normal", "High" };
+
+        FMOD_DSP_INIT_PARAMDESC_FLOAT(p_pitch, "Pitch", "x", "Pitch ratio. 0.5 to 2.0. Default = 1.0", FMOD_WSOLA_PARAM_PITCH_MIN, FMOD_WSOLA_PARAM_PITCH_MAX, FMOD_WSOLA_PARAM_PITCH_DEFAULT);
+        FMOD_DSP_INIT_PARAMDESC_INT_ENUMERATED(p_quality, "Quality", "", "Overlap and search resolution. Fast, Normal or High. Default = Normal", FMOD_WSOLA_QUALITY_NORMAL, quality_names);
+
+        return &FMOD_Wsola_Desc;
+    }
+}
+
+/*
+    Dot product of a and b plus the energy of b, 'length' is a multiple of 4.
+*/
+static void FMOD_Wsola_correlate(const float *a, const float *b, int length, float *xy, float *yy)
+{
+#if defined(FMOD_WSOLA_SSE)
+    __m128 sumxy = _mm_setzero_ps();
+    __m128 sumyy = _mm_setzero_ps();
+    for (int i = 0; i < length; i += 4)
+    {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 vb = _mm_loadu_ps(b + i);
+        sumxy = _mm_add_ps(sumxy, _mm_mul_ps(va, vb));
+        sumyy = _mm_add_ps(sumyy, _mm_mul_ps(vb, vb));
+    }
+    float partxy[4], partyy[4];
+    _mm_storeu_ps(partxy, sumxy);
+    _mm_storeu_ps(partyy, sumyy);
+    *xy = partxy[0] + partxy[1] + partxy[2] + partxy[3];
+    *yy = partyy[0] + partyy[1] + partyy[2] + partyy[3];
+#elif defined(FMOD_WSOLA_NEON)
+    float32x4_t sumxy = vdupq_n_f32(0.0f);
+    float32x4_t sumyy = vdupq_n_f32(0.0f);
+    for (int i = 0; i < length; i += 4)
+    {
+        float32x4_t va = vld1q_f32(a + i);
+        float32x4_t vb = vld1q_f32(b + i);
+        sumxy = vmlaq_f32(sumxy, va, vb);
+        sumyy = vmlaq_f32(sumyy, vb, vb);
+    }
+    *xy = vaddvq_f32(sumxy);
+    *yy = vaddvq_f32(sumyy);
+#else
+    float sumxy = 0.0f, sumyy = 0.0f;
+    for (int i = 0; i < length; i++)
+    {
+        sumxy += a[i] * b[i];
+        sumyy += b[i] * b[i];
+    }
+    *xy = sumxy;
+    *yy = sumyy;
+#endif
+}
+
+class FMODWsolaState
+{
+public:
+    FMODWsolaState();
+
+    FMOD_RESULT init(FMOD_DSP_STATE *dsp_state);
+    void        release(FMOD_DSP_STATE *dsp_state);
+    void        read(float *inbuffer, float *outbuffer, unsigned int length, int channels);
+    void        reset();
+    bool        shouldProcess(bool inputsidle, unsigned int length);
+    void        setPitch(float pitch)   { m_pitch = pitch; }
+    void        setQuality(int quality) { m_pending_quality = quality; }
+    float       pitch() const           { return m_pitch; }
+    int         quality() const         { return m_pending_quality; }
+
+private:
+    void        configure(int quality);
+    void        write(const float *inbuffer, unsigned int length, int channels);
+    void        startSplice(int direction);
+    float       sample(double pos, int channel) const;
+
+    int             m_rate;
+    unsigned int    m_ringsize;             // Frames, power of two
+    unsigned int    m_mask;
+    float          *m_ring;                 // Interleaved history, m_ringsize * FMOD_WSOLA_MAX_CHANNELS
+    float          *m_mono;                 // Mono downmix, written twice so any window up to m_ringsize is contiguous
+    int             m_channels;
+    unsigned int    m_written;              // Frames written so far, starts one ring ahead so positions stay positive
+    double          m_pos;                  // Read position in frames
+    double          m_fadepos;              // Read position of the stream being faded in
+    bool            m_fading;
+    int             m_fadecount;
+
+    float           m_pitch;
+    int             m_quality;
+    int             m_pending_quality;
+    int             m_overlap;              // Cross fade length
+    int             m_corrlength;           // Correlation window, multiple of 4
+    int             m_jumpmin;
+    int             m_jumpmax;
+    int             m_step;
+    int             m_delaymin;             // Window for the distance between write and read position
+    int             m_delaymax;
+    int             m_tail;                 // Frames still to play out after the inputs went idle, -1 once reset
+};
+
+FMODWsolaState::FMODWsolaState()
+{
+    m_ring = 0;
+    m_mono = 0;
+    m_pitch = FMOD_WSOLA_PARAM_PITCH_DEFAULT;
+    m_quality = m_pending_quality = FMOD_WSOLA_QUALITY_NORMAL;
+    m_channels = 0;
+}
+
+FMOD_RESULT FMODWsolaState::init(FMOD_DSP_STATE *dsp_state)
+{
+    FMOD_RESULT result = FMOD_DSP_GETSAMPLERATE(dsp_state, &m_rate);
+    if (result != FMOD_OK)
+    {
+        return result;
+    }
+
+    m_ringsize = 1;
+    while (m_ringsize < (unsigned int)(m_rate * FMOD_WSOLA_HISTORY_SECONDS))
+    {
+        m_ringsize <<= 1;
+    }
+    m_mask = m_ringsize - 1;
+
+    m_ring = (float *)FMOD_DSP_ALLOC(dsp_state, m_ringsize * FMOD_WSOLA_MAX_CHANNELS * sizeof(float));
+    m_mono = (float *)FMOD_DSP_ALLOC(dsp_state, m_ringsize * 2 * sizeof(float));
+    if (!m_ring || !m_mono)
+    {
+        return FMOD_ERR_MEMORY;
+    }
+
+    configure(m_quality);
+    reset();
+    return FMOD_OK;
+}
+
+void FMODWsolaState::release(FMOD_DSP_STATE *dsp_state)
+{
+    if (m_ring)
+    {
+        FMOD_DSP_FREE(dsp_state, m_ring);
+    }
+    if (m_mono)
+    {
+        FMOD_DSP_FREE(dsp_state, m_mono);
+    }
+}
+
+void FMODWsolaState::configure(int quality)
+{
+    const FMODWsolaQuality &q = FMOD_Wsola_Qualities[quality];
+
+    m_quality    = quality;
+    m_overlap    = (int)(q.overlapms * m_rate / 1000.0f);
+    m_corrlength = (int)(q.correlationms * m_rate / 1000.0f) & ~3;
+    m_jumpmin    = m_overlap + m_rate / 500;    // Never jump less than the fade plus 2 ms, or the next splice comes straight away
+    m_jumpmax    = m_jumpmin + (int)(q.searchms * m_rate / 1000.0f);
+    m_step       = q.step;
+
+    /*
+        Reading ahead of the play position for the correlation and the fade must stay behind the write position,
+        and a full jump must fit on either side of the window.
+    */
+    m_delaymin   = m_overlap + m_corrlength + 4;
+    m_delaymax   = m_delaymin + m_jumpmax;
+}
+
+void FMODWsolaState::reset()
+{
+    memset(m_ring, 0, m_ringsize * FMOD_WSOLA_MAX_CHANNELS * sizeof(float));
+    memset(m_mono, 0, m_ringsize * 2 * sizeof(float));
+
+    m_written = m_ringsize;
+    m_pos = m_written - (m_delaymin + m_delaymax) / 2;
+    m_fading = false;
+    m_fadecount = 0;
+    m_tail = -1;
+}
+
+/*
+    The output lags the input by up to the delay window plus a fade, keep going on silence until that has
+    played out. The history is cleared afterwards so a resumed input does not splice against stale audio.
+*/
+bool FMODWsolaState::shouldProcess(bool inputsidle, unsigned int length)
+{
+    if (!inputsidle)
+    {
+        m_tail = m_delaymax + m_overlap;
+        return true;
+    }
+    if (m_tail > 0)
+    {
+        m_tail -= length;
+        return true;
+    }
+    if (m_tail != -1)
+    {
+        reset();
+    }
+    return false;
+}
+
+void FMODWsolaState::write(const float *inbuffer, unsigned int length, int channels)
+{
+    float scale = 1.0f / channels;
+
+    for (unsigned int i = 0; i < length; i++)
+    {
+        unsigned int index = (m_written + i) & m_mask;
+        float       *frame = m_ring + index * FMOD_WSOLA_MAX_CHANNELS;
+        float        mono = 0.0f;
+
+        for (int ch = 0; ch < channels; ch++)
+        {
+            frame[ch] = inbuffer[i * channels + ch];
+            mono += frame[ch];
+        }
+
+        m_mono[index] = m_mono[index + m_ringsize] = mono * scale;
+    }
+
+    m_written += length;
+}
+
+float FMODWsolaState::sample(double pos, int channel) const
+{
+    unsigned int index = (unsigned int)pos;
+    float        frac  = (float)(pos - index);
+    float        a     = m_ring[(index & m_mask) * FMOD_WSOLA_MAX_CHANNELS + channel];
+    float        b     = m_ring[((index + 1) & m_mask) * FMOD_WSOLA_MAX_CHANNELS + channel];
+
+    return a + (b - a) * frac;
+}
+
+/*
+    Find the jump (back for direction -1, forward for +1) whose waveform best continues what is playing now.
+*/
+void FMODWsolaState::startSplice(int direction)
+{
+    unsigned int base = (unsigned int)m_pos;
+    const float *reference = m_mono + (base & m_mask);
+    float        bestscore = -1e30f;
+    int          bestjump = m_jumpmin;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        int from = m_jumpmin, to = m_jumpmax, step = m_step;
+
+        if (pass == 1)
+        {
+            if (m_step == 1)
+            {
+                break;
+            }
+            from = (bestjump - m_step + 1 > m_jumpmin) ? bestjump - m_step + 1 : m_jumpmin;
+            to   = (bestjump + m_step - 1 < m_jumpmax) ? bestjump + m_step - 1 : m_jumpmax;
+            step = 1;
+        }
+
+        for (int jump = from; jump <= to; jump += step)
+        {
+            const float *candidate = m_mono + ((base + direction * jump) & m_mask);
+            float        xy, yy;
+
+            FMOD_Wsola_correlate(reference, candidate, m_corrlength, &xy, &yy);
+
+            float score = xy / sqrtf(yy + 1e-9f);
+            if (score > bestscore)
+            {
+                bestscore = score;
+                bestjump = jump;
+            }
+        }
+    }
+
+    m_fadepos = m_pos + direction * bestjump;
+    m_fading = true;
+    m_fadecount = 0;
+}
+
+void FMODWsolaState::read(float *inbuffer, float *outbuffer, unsigned int length, int channels)
+{
+    if (channels > FMOD_WSOLA_MAX_CHANNELS)
+    {
+        memcpy(outbuffer, inbuffer, length * channels * sizeof(float));
+        return;
+    }
+    if (channels != m_channels)
+    {
+        m_channels = channels;
+        reset();
+    }
+
+    while (length)
+    {
+        unsigned int chunk = (length > FMOD_WSOLA_CHUNK) ? FMOD_WSOLA_CHUNK : length;
+        unsigned int start = m_written;
+
+        write(inbuffer, chunk, channels);
+
+        for (unsigned int i = 0; i < chunk; i++)
+        {
+            if (!m_fading)
+            {
+                if (m_pending_quality != m_quality)
+                {
+                    configure(m_pending_quality);
+                }
+
+                double delay = (start + i) - m_pos;
+                if (m_pitch > 1.0f && delay < m_delaymin)
+                {
+                    startSplice(-1);
+                }
+                else if (m_pitch < 1.0f && delay > m_delaymax)
+                {
+                    startSplice(1);
+                }
+            }
+
+            float *out = outbuffer + i * channels;
+            if (m_fading)
+            {
+                float fadein = (m_fadecount + 0.5f) / m_overlap;
+                for (int ch = 0; ch < channels; ch++)
+                {
+                    out[ch] = sample(m_pos, ch) * (1.0f - fadein) + sample(m_fadepos, ch) * fadein;
+                }
+
+                m_fadepos += m_pitch;
+                if (++m_fadecount >= m_overlap)
+                {
+                    m_pos = m_fadepos;
+                    m_fading = false;
+                    continue;
+                }
+            }
+            else
+            {
+                for (int ch = 0; ch < channels; ch++)
+                {
+                    out[ch] = sample(m_pos, ch);
+                }
+            }
+            m_pos += m_pitch;
+        }
+
+        inbuffer += chunk * channels;
+        outbuffer += chunk * channels;
+        length -= chunk;
+
+        if (m_written >= 0x80000000u)
+        {
+            /* Rebase before the frame counter wraps, by a multiple of the ring size so indices stay put */
+            m_written -= 0x40000000u;
+            m_pos -= 0x40000000u;
+            m_fadepos -= 0x40000000u;
+        }
+    }
+}
+
+FMOD_RESULT F_CALL FMOD_Wsola_dspcreate(FMOD_DSP_STATE *dsp_state)
+{
+    void *mem = FMOD_DSP_ALLOC(dsp_state, sizeof(FMODWsolaState));
+    if (!mem)
+    {
+        return FMOD_ERR_MEMORY;
+    }
+
+    FMODWsolaState *state = new (mem) FMODWsolaState();
+    dsp_state->plugindata = state;
+
+    FMOD_RESULT result = state->init(dsp_state);
+    if (result != FMOD_OK)
+    {
+        state->release(dsp_state);
+        FMOD_DSP_FREE(dsp_state, state);
+        dsp_state->plugindata = 0;
+    }
+    return result;
+}
+
+FMOD_RESULT F_CALL FMOD_Wsola_dsprelease(FMOD_DSP_STATE *dsp_state)
+{
+    FMODWsolaState *state = (FMODWsolaState *)dsp_state->plugindata;
+    state->release(dsp_state);
+    FMOD_DSP_FREE(dsp_state, state);
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL FMOD_Wsola_dspread(FMOD_DSP_STATE *dsp_state, float *inbuffer, float *outbuffer, unsigned int length, int inchannels, int * /*outchannels*/)
+{
+    FMODWsolaState *state = (FMODWsolaState *)dsp_state->plugindata;
+    state->read(inbuffer, outbuffer, length, inchannels); // input and output channels count match for this effect
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL FMOD_Wsola_dspreset(FMOD_DSP_STATE *dsp_state)
+{
+    FMODWsolaState *state = (FMODWsolaState *)dsp_state->plugindata;
+    state->reset();
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL FMOD_Wsola_dspsetparamfloat(FMOD_DSP_STATE *dsp_state, int index, float value)
+{
+    FMODWsolaState *state = (FMODWsolaState *)dsp_state->plugindata;
+
+    switch (index)
+    {
+    case FMOD_WSOLA_PARAM_PITCH:
+        state->setPitch(value);
+        return FMOD_OK;
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
+
+FMOD_RESULT F_CALL FMOD_Wsola_dspgetparamfloat(FMOD_DSP_STATE *dsp_state, int index, float *value, char *valuestr)
+{
+    FMODWsolaState *state = (FMODWsolaState *)dsp_state->plugindata;
+
+    switch (index)
+    {
+    case FMOD_WSOLA_PARAM_PITCH:
+        *value = state->pitch();
+        if (valuestr) snprintf(valuestr, FMOD_DSP_GETPARAM_VALUESTR_LENGTH, "%.2f x", state->pitch());
+        return FMOD_OK;
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
+
+FMOD_RESULT F_CALL FMOD_Wsola_dspsetparamint(FMOD_DSP_STATE *dsp_state, int index, int value)
+{
+    FMODWsolaState *state = (FMODWsolaState *)dsp_state->plugindata;
+
+    switch (index)
+    {
+    case FMOD_WSOLA_PARAM_QUALITY:
+        state->setQuality(value);
+        return FMOD_OK;
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
+
+FMOD_RESULT F_CALL FMOD_Wsola_dspgetparamint(FMOD_DSP_STATE *dsp_state, int index, int *value, char *valuestr)
+{
+    FMODWsolaState *state = (FMODWsolaState *)dsp_state->plugindata;
+
+    switch (index)
+    {
+    case FMOD_WSOLA_PARAM_QUALITY:
+        *value = state->quality();
+        if (valuestr) snprintf(valuestr, FMOD_DSP_GETPARAM_VALUESTR_LENGTH, "%s", p_quality.intdesc.valuenames[state->quality()]);
+        return FMOD_OK;
+    }
+
+    return FMOD_ERR_INVALID_PARAM;
+}
+
+FMOD_RESULT F_CALL FMOD_Wsola_shouldiprocess(FMOD_DSP_STATE *dsp_state, FMOD_BOOL inputsidle, unsigned int length, FMOD_CHANNELMASK /*inmask*/, int /*inchannels*/, FMOD_SPEAKERMODE /*speakermode*/)
+{
+    FMODWsolaState *state = (FMODWsolaState *)dsp_state->plugindata;
+
+    if (!state->shouldProcess(inputsidle != 0, length))
+    {
+        return FMOD_ERR_DSP_DONTPROCESS;
+    }
+
+    return FMOD_OK;
+}
@@ -0,0 +1,390 @@
+/*===============================================================================================
+ OUTPUT_PORTS.DLL
+ Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+ Shows how to write an FMOD output plugin that supports auxiliary ports.
+
+ Channel groups attached with System::attachChannelGroupToPort are not mixed into the main
+ output, FMOD asks the output plugin to open a port for them (openport) and keeps a separate
+ submix per port. After each FMOD_OUTPUT_READFROMMIXER the plugin fetches the submix of every
+ open port with FMOD_OUTPUT_COPYPORT, so voice chat, licensed music and the main mix come out of
+ a single mixer pass, with no second System.
+
+ The plugin runs the mixer from its own thread at the DSP block rate and writes the main mix and
+ each port into a ring (see output_ports.h), returned by System::getOutputHandle. A real plugin
+ would hand the main mix to the device and the ports to the voice chat encoder, broadcast
+ stream or second device instead.
+
+===============================================================================================*/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <windows.h>
+
+#include "fmod.hpp"
+#include "fmod_output.h"
+#include "output_ports.h"
+
+typedef struct
+{
+    OUTPUT_PORTS_SINKS  sinks;
+    FMOD_OUTPUT_STATE  *output;
+    CRITICAL_SECTION    portcrit;       /* Ports open and close on the API thread while the mix thread copies */
+    HANDLE              thread;
+    volatile BOOL       quit;
+    unsigned int        blocklength;
+    float              *mixbuffer;
+} outputports_state;
+
+FMOD_OUTPUT_DESCRIPTION portsoutput;
+
+FMOD_RESULT F_CALL OutputPorts_GetNumDriversCallback(FMOD_OUTPUT_STATE *output_state, int *numdrivers);
+FMOD_RESULT F_CALL OutputPorts_GetDriverInfoCallback(FMOD_OUTPUT_STATE *output_state, int id, char *name, int namelen, FMOD_GUID *guid, int *systemrate, FMOD_SPEAKERMODE *speakermode, int *speakermodechannels);
+FMOD_RESULT F_CALL OutputPorts_InitCallback(FMOD_OUTPUT_STATE *output_state, int selecteddriver, FMOD_INITFLAGS flags, int *outputrate, FMOD_SPEAKERMODE *speakermode, int *speakermodechannels, FMOD_SOUND_FORMAT *outputformat, int dspbufferlength, int *dspnumbuffers, int *dspnumadditionalbuffers, void *extradriverdata);
+FMOD_RESULT F_CALL OutputPorts_StartCallback(FMOD_OUTPUT_STATE *output_state);
+FMOD_RESULT F_CALL OutputPorts_StopCallback(FMOD_OUTPUT_STATE *output_state);
+FMOD_RESULT F_CALL OutputPorts_CloseCallback(FMOD_OUTPUT_STATE *output_state);
+FMOD_RESULT F_CALL OutputPorts_GetHandleCallback(FMOD_OUTPUT_STATE *output_state, void **handle);
+FMOD_RESULT F_CALL OutputPorts_OpenPortCallback(FMOD_OUTPUT_STATE *output_state, FMOD_PORT_TYPE portType, FMOD_PORT_INDEX portIndex, int *portId, int *portRate, int *portChannels, FMOD_SOUND_FORMAT *portFormat);
+FMOD_RESULT F_CALL OutputPorts_ClosePortCallback(FMOD_OUTPUT_STATE *output_state, int portId);
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    FMODGetOutputDescription is mandantory for every fmod plugin.  This is the symbol the registerplugin function searches for.
+    Must be declared with F_CALL to make it export as stdcall.
+*/
+F_EXPORT FMOD_OUTPUT_DESCRIPTION* F_CALL FMODGetOutputDescription()
+{
+    memset(&portsoutput, 0, sizeof(FMOD_OUTPUT_DESCRIPTION));
+
+    portsoutput.apiversion    = FMOD_OUTPUT_PLUGIN_VERSION;
+    portsoutput.name          = "FMOD Port Output";
+    portsoutput.version       = 0x00010000;
+    portsoutput.method        = FMOD_OUTPUT_METHOD_MIX_DIRECT;
+    portsoutput.getnumdrivers = OutputPorts_GetNumDriversCallback;
+    portsoutput.getdriverinfo = OutputPorts_GetDriverInfoCallback;
+    portsoutput.init          = OutputPorts_InitCallback;
+    portsoutput.start         = OutputPorts_StartCallback;
+    portsoutput.stop          = OutputPorts_StopCallback;
+    portsoutput.close         = OutputPorts_CloseCallback;
+    portsoutput.gethandle     = OutputPorts_GetHandleCallback;
+    portsoutput.openport      = OutputPorts_OpenPortCallback;
+    portsoutput.closeport     = OutputPorts_ClosePortCallback;
+
+    return &portsoutput;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+
+/*
+    Copy frames into a sink ring, dropping what doesn't fit rather than blocking the mixer.
+*/
+static void OutputPorts_WriteRing(OUTPUT_PORTS_RING *ring, const float *src, unsigned int length)
+{
+    unsigned int space = ring->frames - (ring->written - ring->read);
+
+    if (length > space)
+    {
+        ring->overruns += length - space;
+        length = space;
+    }
+
+    for (unsigned int i = 0; i < length; i++)
+    {
+        unsigned int pos = (ring->written + i) % ring->frames;
+        memcpy(&ring->buffer[pos * OUTPUT_PORTS_CHANNELS], &src[i * OUTPUT_PORTS_CHANNELS], OUTPUT_PORTS_CHANNELS * sizeof(float));
+    }
+
+    ring->written += length;
+}
+
+
+static FMOD_RESULT OutputPorts_AllocRing(FMOD_OUTPUT_STATE *output_state, OUTPUT_PORTS_RING *ring)
+{
+    ring->buffer = (float *)FMOD_OUTPUT_ALLOC(output_state, OUTPUT_PORTS_RING_FRAMES * OUTPUT_PORTS_CHANNELS * sizeof(float), 16);
+    if (!ring->buffer)
+    {
+        return FMOD_ERR_MEMORY;
+    }
+
+    ring->frames   = OUTPUT_PORTS_RING_FRAMES;
+    ring->written  = 0;
+    ring->read     = 0;
+    ring->overruns = 0;
+
+    return FMOD_OK;
+}
+
+
+static void OutputPorts_FreeRing(FMOD_OUTPUT_STATE *output_state, OUTPUT_PORTS_RING *ring)
+{
+    ring->open = 0;
+    if (ring->buffer)
+    {
+        FMOD_OUTPUT_FREE(output_state, ring->buffer);
+        ring->buffer = 0;
+    }
+}
+
+
+/*
+    One mixer pass: the main mix, then the submix of every open port for the same block.
+*/
+static void OutputPorts_MixBlock(outputports_state *state)
+{
+    FMOD_OUTPUT_STATE *output_state = state->output;
+
+    if (FMOD_OUTPUT_READFROMMIXER(output_state, state->mixbuffer, state->blocklength) != FMOD_OK)
+    {
+        return;
+    }
+    OutputPorts_WriteRing(&state->sinks.main, state->mixbuffer, state->blocklength);
+
+    EnterCriticalSection(&state->portcrit);
+    for (int i = 0; i < OUTPUT_PORTS_MAX_PORTS; i++)
+    {
+        OUTPUT_PORTS_RING *port = &state->sinks.ports[i];
+
+        if (port->open && FMOD_OUTPUT_COPYPORT(output_state, i, state->mixbuffer, state->blocklength) == FMOD_OK)
+        {
+            OutputPorts_WriteRing(port, state->mixbuffer, state->blocklength);
+        }
+    }
+    LeaveCriticalSection(&state->portcrit);
+}
+
+
+static DWORD WINAPI OutputPorts_MixThread(LPVOID param)
+{
+    outputports_state *state = (outputports_state *)param;
+    LARGE_INTEGER      freq, now, next, start, end;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&next);
+
+    LONGLONG blockticks = freq.QuadPart * state->blocklength / state->sinks.rate;
+
+    while (!state->quit)
+    {
+        QueryPerformanceCounter(&now);
+        if (now.QuadPart < next.QuadPart)
+        {
+            Sleep(1);
+            continue;
+        }
+
+        QueryPerformanceCounter(&start);
+        OutputPorts_MixBlock(state);
+        QueryPerformanceCounter(&end);
+
+        state->sinks.mixtimeus += (unsigned int)((end.QuadPart - start.QuadPart) * 1000000 / freq.QuadPart);
+        state->sinks.mixes++;
+
+        next.QuadPart += blockticks;
+        if (now.QuadPart - next.QuadPart > blockticks * 4)
+        {
+            next = now;     /* Fell behind by more than a few blocks, don't try to catch up */
+        }
+    }
+
+    return 0;
+}
+
+
+FMOD_RESULT F_CALL OutputPorts_GetNumDriversCallback(FMOD_OUTPUT_STATE * /*output_state*/, int *numdrivers)
+{
+    *numdrivers = 1;
+
+    return FMOD_OK;
+}
+
+
+FMOD_RESULT F_CALL OutputPorts_GetDriverInfoCallback(FMOD_OUTPUT_STATE * /*output_state*/, int /*id*/, char *name, int namelen, FMOD_GUID * /*guid*/, int * /*systemrate*/, FMOD_SPEAKERMODE *speakermode, int *speakermodechannels)
+{
+    strncpy(name, "Port sinks", namelen);
+
+    *speakermode = FMOD_SPEAKERMODE_STEREO;
+    *speakermodechannels = OUTPUT_PORTS_CHANNELS;
+
+    return FMOD_OK;
+}
+
+
+FMOD_RESULT F_CALL OutputPorts_InitCallback(FMOD_OUTPUT_STATE *output_state, int /*selecteddriver*/, FMOD_INITFLAGS /*flags*/, int *outputrate, FMOD_SPEAKERMODE *speakermode, int *speakermodechannels, FMOD_SOUND_FORMAT *outputformat, int dspbufferlength, int * /*dspnumbuffers*/, int * /*dspnumadditionalbuffers*/, void * /*extradriverdata*/)
+{
+    outputports_state *state;
+    FMOD_RESULT        result;
+
+    state = (outputports_state *)calloc(sizeof(outputports_state), 1);
+    if (!state)
+    {
+        return FMOD_ERR_MEMORY;
+    }
+    output_state->plugindata = state;
+
+    *outputformat        = FMOD_SOUND_FORMAT_PCMFLOAT;
+    *speakermode         = FMOD_SPEAKERMODE_STEREO;
+    *speakermodechannels = OUTPUT_PORTS_CHANNELS;
+
+    state->output      = output_state;
+    state->blocklength = dspbufferlength;
+    state->sinks.rate  = *outputrate;
+
+    InitializeCriticalSection(&state->portcrit);
+
+    /*
+        The port buffers are the same size as the main one, ports run at the output rate and channel count.
+    */
+    state->mixbuffer = (float *)FMOD_OUTPUT_ALLOC(output_state, dspbufferlength * OUTPUT_PORTS_CHANNELS * sizeof(float), 16);
+    if (!state->mixbuffer)
+    {
+        return FMOD_ERR_MEMORY;
+    }
+
+    result = OutputPorts_AllocRing(output_state, &state->sinks.main);
+    if (result != FMOD_OK)
+    {
+        return result;
+    }
+    state->sinks.main.open = 1;
+
+    return FMOD_OK;
+}
+
+
+FMOD_RESULT F_CALL OutputPorts_StartCallback(FMOD_OUTPUT_STATE *output_state)
+{
+    outputports_state *state = (outputports_state *)output_state->plugindata;
+
+    state->quit = FALSE;
+    state->thread = CreateThread(NULL, 0, OutputPorts_MixThread, state, 0, NULL);
+    if (!state->thread)
+    {
+        return FMOD_ERR_OUTPUT_INIT;
+    }
+
+    SetThreadPriority(state->thread, THREAD_PRIORITY_TIME_CRITICAL);
+
+    return FMOD_OK;
+}
+
+
+FMOD_RESULT F_CALL OutputPorts_StopCallback(FMOD_OUTPUT_STATE *output_state)
+{
+    outputports_state *state = (outputports_state *)output_state->plugindata;
+
+    if (state->thread)
+    {
+        state->quit = TRUE;
+        WaitForSingleObject(state->thread, INFINITE);
+        CloseHandle(state->thread);
+        state->thread = NULL;
+    }
+
+    return FMOD_OK;
+}
+
+
+FMOD_RESULT F_CALL OutputPorts_CloseCallback(FMOD_OUTPUT_STATE *output_state)
+{
+    outputports_state *state = (outputports_state *)output_state->plugindata;
+
+    if (!state)
+    {
+        return FMOD_OK;
+    }
+
+    for (int i = 0; i < OUTPUT_PORTS_MAX_PORTS; i++)
+    {
+        OutputPorts_FreeRing(output_state, &state->sinks.ports[i]);
+    }
+    OutputPorts_FreeRing(output_state, &state->sinks.main);
+
+    if (state->mixbuffer)
+    {
+        FMOD_OUTPUT_FREE(output_state, state->mixbuffer);
+    }
+
+    DeleteCriticalSection(&state->portcrit);
+
+    free(state);
+    output_state->plugindata = 0;
+
+    return FMOD_OK;
+}
+
+
+FMOD_RESULT F_CALL OutputPorts_GetHandleCallback(FMOD_OUTPUT_STATE *output_state, void **handle)
+{
+    outputports_state *state = (outputports_state *)output_state->plugindata;
+
+    *handle = &state->sinks;
+
+    return FMOD_OK;
+}
+
+
+/*
+    Called when a channel group is attached to a port type / index that has no port yet. The id handed
+    back is what FMOD passes to closeport and what the plugin passes to copyport.
+*/
+FMOD_RESULT F_CALL OutputPorts_OpenPortCallback(FMOD_OUTPUT_STATE *output_state, FMOD_PORT_TYPE portType, FMOD_PORT_INDEX portIndex, int *portId, int *portRate, int *portChannels, FMOD_SOUND_FORMAT *portFormat)
+{
+    outputports_state *state = (outputports_state *)output_state->plugindata;
+    FMOD_RESULT        result = FMOD_ERR_OUTPUT_CREATEBUFFER;     /* No free port */
+
+    if (portType != FMOD_PORT_TYPE_VOICE && portType != FMOD_PORT_TYPE_MUSIC && portType != FMOD_PORT_TYPE_COPYRIGHT_MUSIC && portType != FMOD_PORT_TYPE_AUX)
+    {
+        return FMOD_ERR_UNSUPPORTED;
+    }
+
+    EnterCriticalSection(&state->portcrit);
+    for (int i = 0; i < OUTPUT_PORTS_MAX_PORTS; i++)
+    {
+        OUTPUT_PORTS_RING *port = &state->sinks.ports[i];
+
+        if (!port->open)
+        {
+            result = OutputPorts_AllocRing(output_state, port);
+            if (result == FMOD_OK)
+            {
+                port->type    = portType;
+                port->index   = portIndex;
+                port->open    = 1;
+                *portId       = i;
+                *portRate     = state->sinks.rate;
+                *portChannels = OUTPUT_PORTS_CHANNELS;
+                *portFormat   = FMOD_SOUND_FORMAT_PCMFLOAT;
+            }
+            break;
+        }
+    }
+    LeaveCriticalSection(&state->portcrit);
+
+    return result;
+}
+
+
+FMOD_RESULT F_CALL OutputPorts_ClosePortCallback(FMOD_OUTPUT_STATE *output_state, int portId)
+{
+    outputports_state *state = (outputports_state *)output_state->plugindata;
+
+    if (portId < 0 || portId >= OUTPUT_PORTS_MAX_PORTS)
+    {
+        return FMOD_ERR_INVALID_PARAM;
+    }
+
+    EnterCriticalSection(&state->portcrit);
+    OutputPorts_FreeRing(output_state, &state->sinks.ports[portId]);
+    LeaveCriticalSection(&state->portcrit);
+
+    return FMOD_OK;
+}
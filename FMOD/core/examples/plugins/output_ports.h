@@ -0,0 +1,42 @@
+/*==============================================================================
+Auxiliary Port Output Plugin Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+Sink structures shared between the port output plugin and the application
+consuming the sinks, returned by System::getOutputHandle.
+==============================================================================*/
+#ifndef OUTPUT_PORTS_H
+#define OUTPUT_PORTS_H
+
+#include "fmod_common.h"
+
+#define OUTPUT_PORTS_MAX_PORTS      4
+#define OUTPUT_PORTS_CHANNELS       2
+#define OUTPUT_PORTS_RING_FRAMES    8192    /* Per sink, about 170 ms at 48 kHz */
+
+/*
+    Single producer (the plugin's mix thread), single consumer ring of interleaved float frames. The
+    positions are running frame counts, the consumer advances 'read' once it has copied the frames out.
+*/
+typedef struct OUTPUT_PORTS_RING
+{
+    FMOD_PORT_TYPE          type;
+    FMOD_PORT_INDEX         index;
+    volatile int            open;               /* Set last, 'type' and 'index' are valid once it reads 1 */
+    float                  *buffer;
+    unsigned int            frames;
+    volatile unsigned int   written;
+    volatile unsigned int   read;
+    volatile unsigned int   overruns;           /* Frames dropped because the consumer fell behind */
+} OUTPUT_PORTS_RING;
+
+typedef struct OUTPUT_PORTS_SINKS
+{
+    OUTPUT_PORTS_RING       main;
+    OUTPUT_PORTS_RING       ports[OUTPUT_PORTS_MAX_PORTS];
+    int                     rate;
+    volatile unsigned int   mixes;
+    volatile unsigned int   mixtimeus;          /* Running total spent mixing and copying ports */
+} OUTPUT_PORTS_SINKS;
+
+#endif
@@ -0,0 +1,382 @@
+/*==============================================================================
+Port Routing Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how to send voice chat and licensed music to their own
+sinks with auxiliary output ports, instead of running extra System objects
+as in the multiple_system example, and measures the difference.
+
+Both setups play the same content (a drum loop for the game mix, a voice
+loop standing in for voice chat and a music stream) and deliver three
+sinks:
+
+ * Ports: one System using the port output plugin (output_ports.dll). The
+   voice and music channel groups are attached to FMOD_PORT_TYPE_VOICE and
+   FMOD_PORT_TYPE_MUSIC, the plugin copies each port's submix into its own
+   sink during the main mix.
+ * Systems: one System per sink, each using the same output plugin without
+   ports, the way separate sinks are usually fed today.
+
+The sinks are drained every frame. Shown per setup are the mix time spent
+in the plugin's mix threads (this includes the FMOD mixer), the DSP CPU
+reported by System::getCPUUsage, FMOD memory from Memory_GetStats and the
+process thread count.
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod.hpp"
+#include "common.h"
+#include "plugins/output_ports.h"
+
+const char *OUTPUT_FILENAME = "output_ports" COMMON_PLUGIN_SUFFIX ".dll";
+
+enum RoutingMode
+{
+    ROUTING_PORTS,
+    ROUTING_SYSTEMS,
+    ROUTING_COUNT
+};
+
+enum SinkType
+{
+    SINK_GAME,
+    SINK_VOICE,
+    SINK_MUSIC,
+    SINK_COUNT
+};
+
+const char *ROUTING_NAMES[ROUTING_COUNT] = { "Ports, 1 System", "3 Systems" };
+const char *SINK_NAMES[SINK_COUNT]       = { "Game", "Voice", "Music" };
+const char *SINK_MEDIA[SINK_COUNT]       = { "drumloop.wav", "singing.wav", "wave.mp3" };
+
+struct RoutingStats
+{
+    bool    measured;
+    float   mixPercent;         /* Plugin mix thread time as a share of wall time */
+    float   dspPercent;
+    int     memoryKB;
+    int     threads;
+};
+
+struct Routing
+{
+    RoutingMode             mode;
+    int                     numSystems;
+    FMOD::System           *systems[SINK_COUNT];
+    FMOD::Sound            *sounds[SINK_COUNT];
+    FMOD::ChannelGroup     *groups[SINK_COUNT];
+    OUTPUT_PORTS_RING      *sinks[SINK_COUNT];
+    OUTPUT_PORTS_SINKS     *outputs[SINK_COUNT];
+    unsigned int            startMixTimeUs[SINK_COUNT];
+    unsigned int            startUs;
+    float                   peak[SINK_COUNT];
+    unsigned int            delivered[SINK_COUNT];
+};
+
+FMOD::System *createSystem(void *extradriverdata)
+{
+    FMOD_RESULT     result;
+    FMOD::System   *system;
+    unsigned int    handle;
+
+    result = FMOD::System_Create(&system);
+    ERRCHECK(result);
+
+    result = system->loadPlugin(OUTPUT_FILENAME, &handle);
+    ERRCHECK(result);
+    result = system->setOutputByPlugin(handle);
+    ERRCHECK(result);
+
+    result = system->init(32, FMOD_INIT_NORMAL, extradriverdata);
+    ERRCHECK(result);
+
+    return system;
+}
+
+void playSink(Routing *routing, FMOD::System *system, SinkType sink)
+{
+    FMOD_RESULT result;
+
+    if (sink == SINK_MUSIC)
+    {
+        result = system->createStream(Common_MediaPath(SINK_MEDIA[sink]), FMOD_LOOP_NORMAL, 0, &routing->sounds[sink]);
+    }
+    else
+    {
+        result = system->createSound(Common_MediaPath(SINK_MEDIA[sink]), FMOD_LOOP_NORMAL, 0, &routing->sounds[sink]);
+    }
+    ERRCHECK(result);
+
+    result = system->createChannelGroup(SINK_NAMES[sink], &routing->groups[sink]);
+    ERRCHECK(result);
+
+    result = system->playSound(routing->sounds[sink], routing->groups[sink], false, 0);
+    ERRCHECK(result);
+}
+
+void createRouting(Routing *routing, RoutingMode mode, void *extradriverdata)
+{
+    FMOD_RESULT result;
+
+    memset(routing, 0, sizeof(Routing));
+    routing->mode = mode;
+
+    if (mode == ROUTING_PORTS)
+    {
+        FMOD::System *system = createSystem(extradriverdata);
+        routing->systems[0] = system;
+        routing->numSystems = 1;
+
+        for (int i = 0; i < SINK_COUNT; i++)
+        {
+            playSink(routing, system, (SinkType)i);
+        }
+
+        /*
+            Detach voice and music from the main mix, each gets its own port. This is what calls the plugin's
+            openport.
+        */
+        result = system->attachChannelGroupToPort(FMOD_PORT_TYPE_VOICE, FMOD_PORT_INDEX_NONE, routing->groups[SINK_VOICE]);
+        ERRCHECK(result);
+        result = system->attachChannelGroupToPort(FMOD_PORT_TYPE_MUSIC, FMOD_PORT_INDEX_NONE, routing->groups[SINK_MUSIC]);
+        ERRCHECK(result);
+
+        result = system->update();
+        ERRCHECK(result);
+
+        OUTPUT_PORTS_SINKS *output;
+        result = system->getOutputHandle((void **)&output);
+        ERRCHECK(result);
+        routing->outputs[0] = output;
+
+        routing->sinks[SINK_GAME] = &output->main;
+    }
+    else
+    {
+        for (int i = 0; i < SINK_COUNT; i++)
+        {
+            FMOD::System *system = createSystem(extradriverdata);
+            routing->systems[i] = system;
+
+            playSink(routing, system, (SinkType)i);
+
+            result = system->update();
+            ERRCHECK(result);
+
+            result = system->getOutputHandle((void **)&routing->outputs[i]);
+            ERRCHECK(result);
+            routing->sinks[i] = &routing->outputs[i]->main;
+        }
+        routing->numSystems = SINK_COUNT;
+    }
+
+    for (int i = 0; i < routing->numSystems; i++)
+    {
+        routing->startMixTimeUs[i] = routing->outputs[i]->mixtimeus;
+    }
+    Common_Time_GetUs(&routing->startUs);
+}
+
+void destroyRouting(Routing *routing)
+{
+    FMOD_RESULT result;
+
+    for (int i = 0; i < SINK_COUNT; i++)
+    {
+        if (routing->sounds[i])
+        {
+            result = routing->sounds[i]->release();
+            ERRCHECK(result);
+        }
+        if (routing->groups[i])
+        {
+            result = routing->groups[i]->release();
+            ERRCHECK(result);
+        }
+    }
+    for (int i = 0; i < routing->numSystems; i++)
+    {
+        result = routing->systems[i]->close();
+        ERRCHECK(result);
+        result = routing->systems[i]->release();
+        ERRCHECK(result);
+    }
+}
+
+/*
+    The ports are opened by the mixer, pick them up once they appear.
+*/
+void findPortSinks(Routing *routing)
+{
+    OUTPUT_PORTS_SINKS *output = routing->outputs[0];
+
+    for (int i = 0; i < OUTPUT_PORTS_MAX_PORTS; i++)
+    {
+        if (output->ports[i].open && output->ports[i].type == FMOD_PORT_TYPE_VOICE)
+        {
+            routing->sinks[SINK_VOICE] = &output->ports[i];
+        }
+        if (output->ports[i].open && output->ports[i].type == FMOD_PORT_TYPE_MUSIC)
+        {
+            routing->sinks[SINK_MUSIC] = &output->ports[i];
+        }
+    }
+}
+
+/*
+    Stand-in for the voice chat encoder / music sink / device: take everything delivered since last frame.
+*/
+void drainSinks(Routing *routing)
+{
+    if (routing->mode == ROUTING_PORTS)
+    {
+        findPortSinks(routing);
+    }
+
+    for (int i = 0; i < SINK_COUNT; i++)
+    {
+        OUTPUT_PORTS_RING *ring = routing->sinks[i];
+        float peak = 0.0f;
+
+        if (!ring || !ring->open)
+        {
+            continue;
+        }
+
+        unsigned int available = ring->written - ring->read;
+        for (unsigned int f = 0; f < available; f++)
+        {
+            const float *frame = &ring->buffer[((ring->read + f) % ring->frames) * OUTPUT_PORTS_CHANNELS];
+            for (int c = 0; c < OUTPUT_PORTS_CHANNELS; c++)
+            {
+                peak = Common_Max(peak, frame[c] < 0.0f ? -frame[c] : frame[c]);
+            }
+        }
+        ring->read += available;
+
+        routing->peak[i] = peak;
+        routing->delivered[i] += available;
+    }
+}
+
+void measure(Routing *routing, RoutingStats *stats)
+{
+    FMOD_RESULT     result;
+    unsigned int    now;
+    unsigned int    mixtimeus = 0;
+    float           dsp = 0.0f;
+    int             currentalloced;
+
+    Common_Time_GetUs(&now);
+    if (now - routing->startUs < 1000000)
+    {
+        return;     /* Let it settle */
+    }
+
+    for (int i = 0; i < routing->numSystems; i++)
+    {
+        FMOD_CPU_USAGE usage;
+
+        result = routing->systems[i]->getCPUUsage(&usage);
+        ERRCHECK(result);
+        dsp += usage.dsp;
+
+        mixtimeus += routing->outputs[i]->mixtimeus - routing->startMixTimeUs[i];
+    }
+
+    result = FMOD::Memory_GetStats(&currentalloced, 0);
+    ERRCHECK(result);
+
+    stats->measured   = true;
+    stats->mixPercent = mixtimeus * 100.0f / (now - routing->startUs);
+    stats->dspPercent = dsp;
+    stats->memoryKB   = currentalloced / 1024;
+    stats->threads    = Common_ThreadCount();
+}
+
+int FMOD_Main()
+{
+    Routing         routing;
+    RoutingStats    stats[ROUTING_COUNT];
+    RoutingMode     mode = ROUTING_PORTS;
+    void           *extradriverdata = 0;
+
+    Common_Init(&extradriverdata);
+
+    memset(stats, 0, sizeof(stats));
+    createRouting(&routing, mode, extradriverdata);
+
+    /*
+        Main loop
+    */
+    do
+    {
+        Common_Update();
+
+        if (Common_BtnPress(BTN_ACTION1))
+        {
+            destroyRouting(&routing);
+            mode = (RoutingMode)((mode + 1) % ROUTING_COUNT);
+            createRouting(&routing, mode, extradriverdata);
+        }
+
+        for (int i = 0; i < routing.numSystems; i++)
+        {
+            FMOD_RESULT result = routing.systems[i]->update();
+            ERRCHECK(result);
+        }
+
+        drainSinks(&routing);
+        measure(&routing, &stats[mode]);
+
+        Common_Draw("==================================================");
+        Common_Draw("Port Routing Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2004-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("");
+        Common_Draw("Press %s to switch routing", Common_BtnStr(BTN_ACTION1));
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+        Common_Draw("");
+        Common_Draw("Routing: %s", ROUTING_NAMES[mode]);
+        Common_Draw("Sink    Delivered (s)   Peak   Overruns");
+        for (int i = 0; i < SINK_COUNT; i++)
+        {
+            OUTPUT_PORTS_RING *ring = routing.sinks[i];
+            int rate = routing.outputs[0]->rate;
+
+            if (ring)
+            {
+                Common_Draw("%-7s %13.1f %6.2f %10u", SINK_NAMES[i], (float)routing.delivered[i] / rate, routing.peak[i], ring->overruns);
+            }
+            else
+            {
+                Common_Draw("%-7s no port", SINK_NAMES[i]);
+            }
+        }
+        Common_Draw("");
+        Common_Draw("                 Mix%%   DSP%%  Memory KB  Threads");
+        for (int i = 0; i < ROUTING_COUNT; i++)
+        {
+            if (stats[i].measured)
+            {
+                Common_Draw("%-15s %5.1f %6.1f %10d %8d", ROUTING_NAMES[i], stats[i].mixPercent, stats[i].dspPercent, stats[i].memoryKB, stats[i].threads);
+            }
+            else
+            {
+                Common_Draw("%-15s     -", ROUTING_NAMES[i]);
+            }
+        }
+
+        Common_Sleep(50);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    /*
+        Shut down
+    */
+    destroyRouting(&routing);
+
+    Common_Close();
+
+    return 0;
+}
@@ -0,0 +1,535 @@
+/*==============================================================================
+Rate Match Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how to remove runtime sample rate conversion by
+resampling assets to the mixer rate ahead of time, and how to find the
+channels that still get resampled while the game is running.
+
+Any channel whose frequency differs from the output rate is resampled by the
+mixer on every block it plays. Assets authored at 44.1 kHz or 22.05 kHz
+(like drumloop.wav and jaguar.wav) pay that cost constantly on a 48 kHz
+mixer.
+
+ * The build step decodes each asset with FMOD, converts it with a windowed
+   sinc polyphase filter to the rate returned by System::getSoftwareFormat
+   and writes it out as a 16 bit wav next to the media. In a real pipeline
+   this runs once at build time, here it runs the first time it is asked for.
+ * The runtime detector walks every playing channel, compares
+   Channel::getFrequency with the output rate and lists the mismatching
+   sound / frequency pairs sorted by how many channels play them, so the
+   assets that cost the most are fixed first.
+
+Loop points are not carried over to the converted files, the whole file is
+used as the loop.
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod.hpp"
+#include "common.h"
+#include <math.h>
+#include <stdio.h>
+
+const int   MAX_CHANNELS            = 64;
+const int   MAX_REPORT              = 6;
+const int   FILTER_TAPS             = 32;       /* Taps per polyphase branch, i.e. input samples per output sample */
+const float FILTER_BANDWIDTH        = 0.92f;    /* Fraction of the lower Nyquist frequency kept */
+const float FILTER_KAISER_BETA      = 8.0f;
+const float AVERAGE_WEIGHT          = 0.05f;
+const double PI                     = 3.14159265358979323846;
+
+struct Asset
+{
+    const char     *filename;
+    int             instances;      /* How many channels play this asset at once */
+    FMOD::Sound    *original;
+    FMOD::Sound    *converted;
+    float           frequency;
+};
+
+Asset gAssets[] =
+{
+    { "drumloop.wav",   6, 0, 0, 0.0f },
+    { "jaguar.wav",     4, 0, 0, 0.0f },
+    { "swish.wav",      2, 0, 0, 0.0f },
+    { "standrews.wav",  2, 0, 0, 0.0f },
+    { "stereo.ogg",     1, 0, 0, 0.0f },
+};
+const int NUM_ASSETS = sizeof(gAssets) / sizeof(gAssets[0]);
+
+struct ResampleEntry
+{
+    FMOD::Sound    *sound;
+    float           frequency;
+    int             count;
+};
+
+/*
+    Build step
+*/
+int greatestCommonDivisor(int a, int b)
+{
+    while (b)
+    {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+
+    for (int k = 1; k < 32; k++)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+/*
+    Lowpass prototype for an upsample by 'up', filter, downsample by 'down' converter, split into 'up' phases
+    of FILTER_TAPS coefficients each. Only the phase an output sample lands on is evaluated, so the cost per
+    output sample is FILTER_TAPS multiplies regardless of the ratio.
+*/
+float *createPolyphaseFilter(int up, int down)
+{
+    int     length = up * FILTER_TAPS;
+    double  centre = (length - 1) * 0.5;
+    double  cutoff = 0.5 * FILTER_BANDWIDTH / (up > down ? up : down);    /* In cycles per upsampled sample */
+    float  *phases = (float *)malloc(length * sizeof(float));
+
+    for (int j = 0; j < length; j++)
+    {
+        double x = j - centre;
+        double sinc = (x == 0.0) ? 1.0 : sin(2.0 * PI * cutoff * x) / (2.0 * PI * cutoff * x);
+        double r = x / centre;
+        double window = besselI0(FILTER_KAISER_BETA * sqrt(1.0 - r * r)) / besselI0(FILTER_KAISER_BETA);
+
+        /* Coefficient j belongs to phase j % up, tap j / up. Scaled by 'up' to keep unity passband gain. */
+        phases[(j % up) * FILTER_TAPS + (j / up)] = (float)(up * 2.0 * cutoff * sinc * window);
+    }
+
+    return phases;
+}
+
+/*
+    Convert interleaved float 'input' from inrate to outrate. Returns the number of output frames.
+*/
+unsigned int resample(const float *input, unsigned int inframes, int channels, int inrate, int outrate, float **output)
+{
+    int          divisor   = greatestCommonDivisor(inrate, outrate);
+    int          up        = outrate / divisor;
+    int          down      = inrate / divisor;
+    unsigned int outframes = (unsigned int)(((unsigned long long)inframes * up + down - 1) / down);
+    float       *phases    = createPolyphaseFilter(up, down);
+
+    *output = (float *)malloc(outframes * channels * sizeof(float));
+
+    for (unsigned int n = 0; n < outframes; n++)
+    {
+        unsigned long long position = (unsigned long long)n * down;
+        long long          base     = (long long)(position / up) + FILTER_TAPS / 2;     /* + half the filter to remove its delay */
+        const float       *phase    = phases + (position % up) * FILTER_TAPS;
+
+        for (int c = 0; c < channels; c++)
+        {
+            float sum = 0.0f;
+
+            for (int k = 0; k < FILTER_TAPS; k++)
+            {
+                long long index = base - k;
+                if (index >= 0 && index < (long long)inframes)
+                {
+                    sum += phase[k] * input[index * channels + c];
+                }
+            }
+
+            (*output)[n * channels + c] = sum;
+        }
+    }
+
+    free(phases);
+    return outframes;
+}
+
+void writeLE(FILE *file, unsigned int value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        fputc((value >> (i * 8)) & 0xFF, file);
+    }
+}
+
+bool writeWav(const char *filename, const float *data, unsigned int frames, int channels, int rate)
+{
+    FILE *file = fopen(filename, "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    unsigned int datalength = frames * channels * 2;
+
+    fwrite("RIFF", 1, 4, file);
+    writeLE(file, 36 + datalength, 4);
+    fwrite("WAVEfmt ", 1, 8, file);
+    writeLE(file, 16, 4);
+    writeLE(file, 1, 2);                    /* PCM */
+    writeLE(file, channels, 2);
+    writeLE(file, rate, 4);
+    writeLE(file, rate * channels * 2, 4);
+    writeLE(file, channels * 2, 2);
+    writeLE(file, 16, 2);
+    fwrite("data", 1, 4, file);
+    writeLE(file, datalength, 4);
+
+    for (unsigned int i = 0; i < frames * channels; i++)
+    {
+        float sample = Common_Clamp(-1.0f, data[i], 1.0f);
+        writeLE(file, (unsigned short)(short)(sample * 32767.0f), 2);
+    }
+
+    fclose(file);
+    return true;
+}
+
+/*
+    Decode a whole sound to interleaved float with Sound::readData
+*/
+unsigned int decodeToFloat(FMOD::Sound *sound, int *channels, float **output)
+{
+    FMOD_RESULT         result;
+    FMOD_SOUND_FORMAT   format;
+    int                 bits;
+    unsigned int        frames, bytes, read;
+
+    result = sound->getFormat(0, &format, channels, &bits);
+    ERRCHECK(result);
+    result = sound->getLength(&frames, FMOD_TIMEUNIT_PCM);
+    ERRCHECK(result);
+
+    bytes = frames * *channels * (bits / 8);
+    unsigned char *raw = (unsigned char *)malloc(bytes);
+
+    result = sound->readData(raw, bytes, &read);
+    if (result != FMOD_ERR_FILE_EOF)
+    {
+        ERRCHECK(result);
+    }
+
+    unsigned int samples = read / (bits / 8);
+    *output = (float *)malloc(samples * sizeof(float));
+
+    for (unsigned int i = 0; i < samples; i++)
+    {
+        const unsigned char *s = raw + i * (bits / 8);
+        float value = 0.0f;
+
+        switch (format)
+        {
+            case FMOD_SOUND_FORMAT_PCM8:     value = (float)(signed char)s[0] / 128.0f; break;
+            case FMOD_SOUND_FORMAT_PCM16:    value = (float)(short)(s[0] | (s[1] << 8)) / 32768.0f; break;
+            case FMOD_SOUND_FORMAT_PCM24:
+            {
+                unsigned int bitsvalue = (unsigned int)s[0] | ((unsigned int)s[1] << 8) | ((unsigned int)s[2] << 16);
+                int          sample = (int)bitsvalue - ((bitsvalue & 0x800000) ? 0x1000000 : 0);    /* Sign extend without shifting into the sign bit */
+                value = (float)sample / 8388608.0f;
+                break;
+            }
+            case FMOD_SOUND_FORMAT_PCM32:
+            {
+                unsigned int bitsvalue = (unsigned int)s[0] | ((unsigned int)s[1] << 8) | ((unsigned int)s[2] << 16) | ((unsigned int)s[3] << 24);
+                value = (float)(int)bitsvalue / 2147483648.0f;
+                break;
+            }
+            case FMOD_SOUND_FORMAT_PCMFLOAT: memcpy(&value, s, sizeof(float)); break;
+            default: break;
+        }
+
+        (*output)[i] = value;
+    }
+
+    free(raw);
+    return samples / *channels;
+}
+
+/*
+    Convert every asset that is not at the output rate and load the result. Returns the time taken in ms.
+*/
+float convertAssets(FMOD::System *system, int outputrate)
+{
+    FMOD_RESULT  result;
+    unsigned int start, end;
+
+    Common_Time_GetUs(&start);
+
+    for (int i = 0; i < NUM_ASSETS; i++)
+    {
+        Asset *asset = &gAssets[i];
+        char   outname[256];
+
+        if ((int)asset->frequency == outputrate)
+        {
+            asset->converted = asset->original;     /* Already at the mixer rate, nothing to do */
+            continue;
+        }
+
+        Common_Format(outname, sizeof(outname), "%.*s_%d.wav", (int)(strrchr(asset->filename, '.') - asset->filename), asset->filename, outputrate);
+
+        FMOD::Sound *decoder;
+        float       *input, *output;
+        int          channels;
+
+        result = system->createSound(Common_MediaPath(asset->filename), FMOD_OPENONLY, 0, &decoder);
+        ERRCHECK(result);
+
+        unsigned int inframes  = decodeToFloat(decoder, &channels, &input);
+        unsigned int outframes = resample(input, inframes, channels, (int)asset->frequency, outputrate, &output);
+
+        result = decoder->release();
+        ERRCHECK(result);
+
+        if (!writeWav(Common_WritePath(outname), output, outframes, channels, outputrate))
+        {
+            Common_Fatal("Could not write %s", outname);
+        }
+
+        free(input);
+        free(output);
+
+        result = system->createSound(Common_WritePath(outname), FMOD_LOOP_NORMAL | FMOD_CREATESAMPLE, 0, &asset->converted);
+        ERRCHECK(result);
+    }
+
+    Common_Time_GetUs(&end);
+    return (end - start) / 1000.0f;
+}
+
+/*
+    Runtime detector
+*/
+int detectResampling(FMOD::System *system, int outputrate, ResampleEntry *entries, int maxentries, int *resampling, int *playing)
+{
+    int numentries = 0;
+
+    *resampling = 0;
+    *playing = 0;
+
+    for (int i = 0; i < MAX_CHANNELS; i++)
+    {
+        FMOD::Channel  *channel;
+        FMOD::Sound    *sound;
+        bool            isplaying = false;
+        float           frequency;
+
+        /* Channels that stopped or were stolen report an error, they are simply not playing */
+        if (system->getChannel(i, &channel) != FMOD_OK || channel->isPlaying(&isplaying) != FMOD_OK || !isplaying)
+        {
+            continue;
+        }
+        if (channel->getFrequency(&frequency) != FMOD_OK || channel->getCurrentSound(&sound) != FMOD_OK)
+        {
+            continue;
+        }
+
+        (*playing)++;
+
+        if (frequency == (float)outputrate)
+        {
+            continue;
+        }
+
+        (*resampling)++;
+
+        int e = 0;
+        while (e < numentries && (entries[e].sound != sound || entries[e].frequency != frequency))
+        {
+            e++;
+        }
+        if (e == numentries)
+        {
+            if (numentries == maxentries)
+            {
+                continue;
+            }
+            entries[e].sound = sound;
+            entries[e].frequency = frequency;
+            entries[e].count = 0;
+            numentries++;
+        }
+        entries[e].count++;
+    }
+
+    /* Most played first, those are worth converting before anything else */
+    for (int i = 1; i < numentries; i++)
+    {
+        ResampleEntry entry = entries[i];
+        int j = i - 1;
+        while (j >= 0 && entries[j].count < entry.count)
+        {
+            entries[j + 1] = entries[j];
+            j--;
+        }
+        entries[j + 1] = entry;
+    }
+
+    return numentries;
+}
+
+void playAssets(FMOD::System *system, bool converted)
+{
+    FMOD_RESULT result;
+
+    for (int i = 0; i < MAX_CHANNELS; i++)
+    {
+        FMOD::Channel *channel;
+
+        result = system->getChannel(i, &channel);
+        ERRCHECK(result);
+
+        channel->stop();    /* Ignore the result, most of these are not playing */
+    }
+
+    for (int i = 0; i < NUM_ASSETS; i++)
+    {
+        for (int j = 0; j < gAssets[i].instances; j++)
+        {
+            FMOD::Channel *channel;
+
+            result = system->playSound(converted ? gAssets[i].converted : gAssets[i].original, 0, false, &channel);
+            ERRCHECK(result);
+
+            result = channel->setVolume(0.1f);
+            ERRCHECK(result);
+        }
+    }
+}
+
+int FMOD_Main()
+{
+    FMOD::System       *system;
+    FMOD_RESULT         result;
+    ResampleEntry       entries[MAX_REPORT];
+    int                 outputrate;
+    bool                converted = false;
+    float               convert_ms = 0.0f;
+    float               average_cpu[2] = { 0.0f, 0.0f };    /* [0] = original, [1] = converted */
+    void               *extradriverdata = 0;
+
+    Common_Init(&extradriverdata);
+
+    /*
+        Create a System object and initialize
+    */
+    result = FMOD::System_Create(&system);
+    ERRCHECK(result);
+
+    result = system->init(MAX_CHANNELS, FMOD_INIT_NORMAL, extradriverdata);
+    ERRCHECK(result);
+
+    result = system->getSoftwareFormat(&outputrate, 0, 0);
+    ERRCHECK(result);
+
+    for (int i = 0; i < NUM_ASSETS; i++)
+    {
+        result = system->createSound(Common_MediaPath(gAssets[i].filename), FMOD_LOOP_NORMAL | FMOD_CREATESAMPLE, 0, &gAssets[i].original);
+        ERRCHECK(result);
+
+        result = gAssets[i].original->getDefaults(&gAssets[i].frequency, 0);
+        ERRCHECK(result);
+    }
+
+    playAssets(system, converted);
+
+    /*
+        Main loop
+    */
+    do
+    {
+        Common_Update();
+
+        if (Common_BtnPress(BTN_ACTION1))
+        {
+            if (!gAssets[0].converted)
+            {
+                convert_ms = convertAssets(system, outputrate);
+            }
+
+            converted = !converted;
+            playAssets(system, converted);
+        }
+
+        result = system->update();
+        ERRCHECK(result);
+
+        int resampling, playing;
+        int numentries = detectResampling(system, outputrate, entries, MAX_REPORT, &resampling, &playing);
+
+        {
+            FMOD_CPU_USAGE usage;
+
+            result = system->getCPUUsage(&usage);
+            ERRCHECK(result);
+
+            float &cpu = average_cpu[converted ? 1 : 0];
+            cpu = (cpu == 0.0f) ? usage.dsp : cpu + AVERAGE_WEIGHT * (usage.dsp - cpu);
+        }
+
+        Common_Draw("==================================================");
+        Common_Draw("Rate Match Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2004-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("");
+        Common_Draw("Press %s to switch original / converted assets", Common_BtnStr(BTN_ACTION1));
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+        Common_Draw("");
+        Common_Draw("Output rate : %d Hz", outputrate);
+        Common_Draw("Assets      : %s", converted ? "Converted" : "Original");
+        if (convert_ms > 0.0f)
+        {
+            Common_Draw("Build step  : %.0f ms", convert_ms);
+        }
+        Common_Draw("Resampling  : %d of %d channels", resampling, playing);
+        for (int i = 0; i < numentries; i++)
+        {
+            char name[64];
+
+            result = entries[i].sound->getName(name, sizeof(name));
+            ERRCHECK(result);
+
+            Common_Draw("  %2dx %-22s %6.0f Hz", entries[i].count, name, entries[i].frequency);
+        }
+        Common_Draw("");
+        Common_Draw("Mixer DSP CPU, original  : %5.1f %%", average_cpu[0]);
+        Common_Draw("Mixer DSP CPU, converted : %5.1f %%", average_cpu[1]);
+
+        Common_Sleep(50);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    /*
+        Shut down
+    */
+    for (int i = 0; i < NUM_ASSETS; i++)
+    {
+        if (gAssets[i].converted && gAssets[i].converted != gAssets[i].original)
+        {
+            result = gAssets[i].converted->release();
+            ERRCHECK(result);
+        }
+        result = gAssets[i].original->release();
+        ERRCHECK(result);
+    }
+    result = system->close();
+    ERRCHECK(result);
+    result = system->release();
+    ERRCHECK(result);
+
+    Common_Close();
+
+    return 0;
+}
@@ -0,0 +1,406 @@
+/*==============================================================================
+Update Pacing Example
+Copyright (c), Firelight Technologies Pty, Ltd 2004-2025.
+
+This example shows how the way System::update is paced affects the time from
+an API command to the mixer acting on it, and how driving the mixer from
+your own job system removes FMOD's mixer and stream threads.
+
+Three pacing modes can be compared:
+
+ * Fixed: the usual example loop, update() once per 50 ms frame. A command
+   waits for the next frame and then for the next mix.
+ * Block aligned: update() is called right after every mix, detected with the
+   FMOD_SYSTEM_CALLBACK_POSTMIX callback, so commands reach the mixer within
+   one DSP block.
+ * Job driven: the system is initialized with FMOD_INIT_MIX_FROM_UPDATE and
+   FMOD_INIT_STREAM_FROM_UPDATE and an 'audio job' thread standing in for a
+   game job system runs the command pump and update() once per DSP block.
+   Mixing and streaming happen inside update(), FMOD creates no mixer or
+   stream thread of its own.
+
+The command under test un-pauses an oscillator at a scheduled time. A DSP
+on the oscillator's channel timestamps the first block with signal, the
+difference is the command to mix latency. The output buffer adds a constant
+on top, shown separately. The process thread count is taken after each
+system is created.
+
+The job tick relies on Common_Sleep(1), so its accuracy depends on the OS
+timer resolution.
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod.hpp"
+#include "common.h"
+
+enum PacingMode
+{
+    PACING_FIXED,
+    PACING_ALIGNED,
+    PACING_JOB,
+    PACING_COUNT
+};
+
+const char  *PACING_NAMES[PACING_COUNT] = { "Fixed 50 ms", "Block aligned", "Job driven" };
+const int    FRAME_MS               = 50;
+const int    COMMAND_INTERVAL_MS    = 300;
+const float  DETECT_THRESHOLD       = 0.001f;
+
+/*
+    Shared with the mixer (or the job thread in job driven mode)
+*/
+struct MixState
+{
+    volatile bool           armed;
+    volatile unsigned int   detectedUs;
+    volatile unsigned int   mixCount;
+};
+
+struct LatencyStats
+{
+    float   averageMs;
+    float   worstMs;
+    int     samples;
+    int     threads;
+};
+
+struct Session
+{
+    FMOD::System   *system;
+    FMOD::Sound    *stream;
+    FMOD::DSP      *oscillator;
+    FMOD::DSP      *detector;
+    FMOD::Channel  *channel;
+    PacingMode      mode;
+    float           blockMs;
+    float           outputMs;
+    MixState        mix;
+
+    /* Command test, driven by whoever paces update() */
+    Common_Mutex    lock;
+    unsigned int    dueUs;
+    bool            sounding;
+    LatencyStats   *stats;
+
+    void           *job;
+    volatile bool   jobQuit;
+};
+
+FMOD_RESULT F_CALL detectorCallback(FMOD_DSP_STATE *dsp_state, float *inbuffer, float *outbuffer, unsigned int length, int inchannels, int *outchannels)
+{
+    MixState *mix;
+    FMOD_DSP_GETUSERDATA(dsp_state, (void **)&mix);
+
+    memcpy(outbuffer, inbuffer, length * inchannels * sizeof(float));
+    *outchannels = inchannels;
+
+    if (mix->armed)
+    {
+        for (unsigned int i = 0; i < length * inchannels; i++)
+        {
+            if (inbuffer[i] > DETECT_THRESHOLD || inbuffer[i] < -DETECT_THRESHOLD)
+            {
+                unsigned int now;
+                Common_Time_GetUs(&now);
+                mix->detectedUs = now;
+                mix->armed = false;
+                break;
+            }
+        }
+    }
+
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL mixCallback(FMOD_SYSTEM *system, FMOD_SYSTEM_CALLBACK_TYPE /*type*/, void * /*commanddata1*/, void * /*commanddata2*/, void * /*userdata*/)
+{
+    MixState *mix;
+    ((FMOD::System *)system)->getUserData((void **)&mix);
+    mix->mixCount++;
+    return FMOD_OK;
+}
+
+/*
+    Issue the command when it is due and collect the result once the mixer has seen it. This is the game side
+    of the test and runs on the thread that paces update().
+*/
+void pumpCommands(Session *session)
+{
+    FMOD_RESULT  result;
+    unsigned int now;
+
+    Common_Mutex_Enter(&session->lock);
+    Common_Time_GetUs(&now);
+
+    if (!session->sounding && (int)(now - session->dueUs) >= 0)
+    {
+        session->mix.armed = true;
+        result = session->channel->setPaused(false);
+        ERRCHECK(result);
+        session->sounding = true;
+    }
+    else if (session->sounding && !session->mix.armed)
+    {
+        LatencyStats *stats = &session->stats[session->mode];
+        float latency = (session->mix.detectedUs - session->dueUs) / 1000.0f;
+
+        stats->averageMs = (stats->averageMs * stats->samples + latency) / (stats->samples + 1);
+        stats->worstMs = Common_Max(stats->worstMs, latency);
+        stats->samples++;
+
+        result = session->channel->setPaused(true);
+        ERRCHECK(result);
+        session->sounding = false;
+        session->dueUs = now + (COMMAND_INTERVAL_MS + rand() % FRAME_MS) * 1000;   /* Random phase against the frame */
+    }
+
+    Common_Mutex_Leave(&session->lock);
+}
+
+/*
+    Stand-in for a game job system: one audio job per DSP block
+*/
+void audioJobThread(void *param)
+{
+    Session *session = (Session *)param;
+    unsigned int next;
+    unsigned int blockUs = (unsigned int)(session->blockMs * 1000.0f);
+
+    Common_Time_GetUs(&next);
+    while (!session->jobQuit)
+    {
+        pumpCommands(session);
+
+        FMOD_RESULT result = session->system->update();     /* Mixes and streams with the MIX/STREAM_FROM_UPDATE flags */
+        ERRCHECK(result);
+
+        next += blockUs;
+
+        unsigned int now;
+        Common_Time_GetUs(&now);
+        if ((int)(now - next) > (int)blockUs)
+        {
+            next = now;     /* Fell more than a block behind, don't try to catch up */
+        }
+        while ((int)(next - now) > 0)
+        {
+            Common_Sleep(1);
+            Common_Time_GetUs(&now);
+        }
+    }
+}
+
+void createSession(Session *session, PacingMode mode, LatencyStats *stats, void *extradriverdata)
+{
+    FMOD_RESULT      result;
+    unsigned int     bufferlength;
+    int              numbuffers, rate;
+    FMOD_INITFLAGS   flags = (mode == PACING_JOB) ? (FMOD_INIT_MIX_FROM_UPDATE | FMOD_INIT_STREAM_FROM_UPDATE) : FMOD_INIT_NORMAL;
+
+    memset(session, 0, sizeof(Session));
+    session->mode = mode;
+    session->stats = stats;
+    Common_Mutex_Create(&session->lock);
+
+    result = FMOD::System_Create(&session->system);
+    ERRCHECK(result);
+
+    result = session->system->init(32, flags, extradriverdata);
+    ERRCHECK(result);
+
+    result = session->system->getDSPBufferSize(&bufferlength, &numbuffers);
+    ERRCHECK(result);
+    result = session->system->getSoftwareFormat(&rate, 0, 0);
+    ERRCHECK(result);
+    session->blockMs = bufferlength * 1000.0f / rate;
+    session->outputMs = session->blockMs * numbuffers;
+
+    result = session->system->setUserData(&session->mix);
+    ERRCHECK(result);
+    result = session->system->setCallback(mixCallback, FMOD_SYSTEM_CALLBACK_POSTMIX);
+    ERRCHECK(result);
+
+    /*
+        Background music stream, so stream decoding is part of the picture
+    */
+    result = session->system->createStream(Common_MediaPath("wave.mp3"), FMOD_LOOP_NORMAL, 0, &session->stream);
+    ERRCHECK(result);
+    {
+        FMOD::Channel *music;
+        result = session->system->playSound(session->stream, 0, false, &music);
+        ERRCHECK(result);
+        result = music->setVolume(0.2f);
+        ERRCHECK(result);
+    }
+
+    /*
+        Oscillator that the command un-pauses, with the detector at the head of its channel
+    */
+    result = session->system->createDSPByType(FMOD_DSP_TYPE_OSCILLATOR, &session->oscillator);
+    ERRCHECK(result);
+    result = session->system->playDSP(session->oscillator, 0, true, &session->channel);
+    ERRCHECK(result);
+    result = session->channel->setVolume(0.3f);
+    ERRCHECK(result);
+
+    {
+        FMOD_DSP_DESCRIPTION dspdesc;
+        memset(&dspdesc, 0, sizeof(dspdesc));
+
+        strncpy(dspdesc.name, "Latency detector", sizeof(dspdesc.name));
+        dspdesc.version             = 0x00010000;
+        dspdesc.numinputbuffers     = 1;
+        dspdesc.numoutputbuffers    = 1;
+        dspdesc.read                = detectorCallback;
+        dspdesc.userdata            = &session->mix;
+
+        result = session->system->createDSP(&dspdesc, &session->detector);
+        ERRCHECK(result);
+    }
+    result = session->channel->addDSP(0, session->detector);
+    ERRCHECK(result);
+
+    Common_Time_GetUs(&session->dueUs);
+    session->dueUs += COMMAND_INTERVAL_MS * 1000;
+
+    if (mode == PACING_JOB)
+    {
+        /*
+            The job thread mixes, so it needs the mixer's stack rather than the small default one.
+        */
+        Common_Thread_Create(audioJobThread, session, FMOD_THREAD_AFFINITY_MIXER, FMOD_THREAD_PRIORITY_MIXER, FMOD_THREAD_STACK_SIZE_MIXER, &session->job);
+    }
+    else
+    {
+        result = session->system->update();
+        ERRCHECK(result);
+    }
+
+    stats[mode].threads = Common_ThreadCount();
+}
+
+void destroySession(Session *session)
+{
+    FMOD_RESULT result;
+
+    if (session->job)
+    {
+        session->jobQuit = true;
+        Common_Thread_Destroy(session->job);
+    }
+
+    result = session->channel->removeDSP(session->detector);
+    ERRCHECK(result);
+    result = session->detector->release();
+    ERRCHECK(result);
+    result = session->oscillator->release();
+    ERRCHECK(result);
+    result = session->stream->release();
+    ERRCHECK(result);
+    result = session->system->close();
+    ERRCHECK(result);
+    result = session->system->release();
+    ERRCHECK(result);
+
+    Common_Mutex_Destroy(&session->lock);
+}
+
+int FMOD_Main()
+{
+    Session         session;
+    LatencyStats    stats[PACING_COUNT];
+    PacingMode      mode = PACING_FIXED;
+    void           *extradriverdata = 0;
+
+    Common_Init(&extradriverdata);
+
+    memset(stats, 0, sizeof(stats));
+    createSession(&session, mode, stats, extradriverdata);
+
+    /*
+        Main loop, one 50 ms UI frame per iteration whatever the pacing
+    */
+    do
+    {
+        Common_Update();
+
+        if (Common_BtnPress(BTN_ACTION1))
+        {
+            destroySession(&session);
+            mode = (PacingMode)((mode + 1) % PACING_COUNT);
+            createSession(&session, mode, stats, extradriverdata);
+        }
+
+        if (mode == PACING_FIXED)
+        {
+            pumpCommands(&session);
+
+            FMOD_RESULT result = session.system->update();
+            ERRCHECK(result);
+        }
+        else if (mode == PACING_ALIGNED)
+        {
+            unsigned int start, now;
+            Common_Time_GetUs(&start);
+            now = start;
+
+            while (now - start < FRAME_MS * 1000)
+            {
+                unsigned int mixcount = session.mix.mixCount;
+                while (session.mix.mixCount == mixcount)
+                {
+                    Common_Sleep(1);
+                }
+
+                pumpCommands(&session);
+
+                FMOD_RESULT result = session.system->update();
+                ERRCHECK(result);
+
+                Common_Time_GetUs(&now);
+            }
+        }
+
+        Common_Draw("==================================================");
+        Common_Draw("Update Pacing Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2004-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("");
+        Common_Draw("Press %s to change pacing mode", Common_BtnStr(BTN_ACTION1));
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+        Common_Draw("");
+        Common_Draw("Mode          : %s", PACING_NAMES[mode]);
+        Common_Draw("DSP block     : %.1f ms", session.blockMs);
+        Common_Draw("Output buffer : +%.1f ms on top of every latency", session.outputMs);
+        Common_Draw("");
+        Common_Draw(" %-14s %7s %9s %6s %8s", "Command->mix", "avg ms", "worst ms", "count", "threads");
+        Common_Mutex_Enter(&session.lock);
+        for (int i = 0; i < PACING_COUNT; i++)
+        {
+            if (stats[i].threads)
+            {
+                Common_Draw("%c%-14s %7.1f %9.1f %6d %8d", i == mode ? '>' : ' ', PACING_NAMES[i], stats[i].averageMs, stats[i].worstMs, stats[i].samples, stats[i].threads);
+            }
+            else
+            {
+                Common_Draw("%c%-14s       -", i == mode ? '>' : ' ', PACING_NAMES[i]);
+            }
+        }
+        Common_Mutex_Leave(&session.lock);
+
+        if (mode != PACING_ALIGNED)
+        {
+            Common_Sleep(FRAME_MS);
+        }
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    /*
+        Shut down
+    */
+    destroySession(&session);
+
+    Common_Close();
+
+    return 0;
+}
@@ -0,0 +1,728 @@
+/*==============================================================================
+Archive Layout Example
+Copyright (c), Firelight Technologies Pty, Ltd 2012-2025.
+
+This example demonstrates laying out banks inside a single archive file in
+the order they are actually read, using a trace recorded through the bank
+file callbacks.
+
+The banks are packed into an archive split into fixed size blocks, in
+alphabetical order to start with. A level load is then run through
+Studio::System::loadBankCustom: banks are loaded, sample data is loaded and
+a few streaming events play for a while. Every read the custom read callback
+serves is recorded as (bank, offset, size).
+
+The optimizer places every block that was read in the order of its first
+read, followed by the blocks that were never touched, and writes a new
+archive with a block map so the banks can still be read at their original
+offsets. Both layouts are scored against the trace with a simple storage
+model (seek cost, throughput, read-ahead window) for a spinning disk and a
+network share, and a replay benchmark reads the trace back from both archive
+files and times it. Put the media directory on the storage to be measured,
+and keep in mind a replay served from the OS file cache shows no difference.
+
+### See Also ###
+* Studio::System::loadBankCustom
+* Studio::Bank::loadSampleData
+* Studio::System::flushSampleLoading
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod_studio.hpp"
+#include "fmod.hpp"
+#include "common.h"
+#include <stdio.h>
+
+static const unsigned int BLOCK_SIZE        = 64 * 1024;
+static const int          MAX_ENTRIES       = 8;
+static const int          MAX_BLOCKS        = 1024;
+static const int          MAX_TRACE         = 32768;
+static const int          GAMEPLAY_MS       = 8000;
+
+static const int   BANK_COUNT = 6;
+static const char* BANK_NAMES[BANK_COUNT] =      // Authoring (alphabetical) order, used for the initial archive
+{
+    "Master.bank",
+    "Master.strings.bank",
+    "Music.bank",
+    "SFX.bank",
+    "VO.bank",
+    "Vehicles.bank",
+};
+static const int   LOAD_ORDER[] = { 0, 1, 5, 3, 2 };     // Level load order, VO is not used by this level
+static const int   LOAD_COUNT = sizeof(LOAD_ORDER) / sizeof(LOAD_ORDER[0]);
+
+static const char* EVENT_NAMES[] =
+{
+    "event:/Ambience/Country",
+    "event:/Music/Level 01",
+    "event:/Vehicles/Ride-on Mower",
+};
+static const int   EVENT_COUNT = sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]);
+
+//
+// Archive layout. The file starts with this header, followed by the block data. Block 'b' of entry 'e' is
+// stored at blockOffset[entry[e].firstBlock + b].
+//
+struct ArchiveEntry
+{
+    char         name[32];
+    unsigned int size;
+    unsigned int firstBlock;
+    unsigned int numBlocks;
+};
+
+struct Archive
+{
+    char         magic[4];
+    int          numEntries;
+    unsigned int numBlocks;
+    ArchiveEntry entry[MAX_ENTRIES];
+    unsigned int blockOffset[MAX_BLOCKS];
+};
+
+//
+// One read served by the custom read callback, in bank relative offsets so it applies to any layout
+//
+struct TraceRecord
+{
+    int          entry;
+    unsigned int offset;
+    unsigned int size;
+};
+
+struct Trace
+{
+    Common_Mutex lock;
+    int          count;
+    bool         recording;
+    TraceRecord  record[MAX_TRACE];
+};
+
+//
+// Storage model used to score a layout
+//
+struct StorageProfile
+{
+    const char*  name;
+    float        seekMs;            // Head seek or request round trip
+    float        megabytesPerSec;
+    unsigned int readAhead;         // Bytes the device or client fetches past every read
+};
+
+static const StorageProfile STORAGE_PROFILES[] =
+{
+    { "Spinning disk",  8.0f, 120.0f, 128 * 1024  },
+    { "Network share",  2.0f,  40.0f, 1024 * 1024 },
+};
+static const int PROFILE_COUNT = sizeof(STORAGE_PROFILES) / sizeof(STORAGE_PROFILES[0]);
+
+struct LayoutScore
+{
+    int   seeks;
+    float ms;
+};
+
+static Trace gTrace;
+
+//
+// Archive reading and writing
+//
+bool readArchive(const char* path, Archive* archive)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        return false;
+    }
+    size_t read = fread(archive, 1, sizeof(Archive), file);
+    fclose(file);
+    return read == sizeof(Archive) && memcmp(archive->magic, "FPAK", 4) == 0;
+}
+
+// Write 'layout' to 'path', taking the data of physical block i from 'sources[i]' at 'sourceOffsets[i]'
+void writeArchive(const char* path, Archive* layout, FILE** sources, const unsigned int* sourceOffsets, const unsigned int* order)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        Common_Fatal("Could not write %s", path);
+    }
+
+    char* block = (char*)malloc(BLOCK_SIZE);
+    unsigned int position = sizeof(Archive);
+
+    fseek(file, position, SEEK_SET);
+    for (unsigned int i = 0; i < layout->numBlocks; i++)
+    {
+        memset(block, 0, BLOCK_SIZE);
+        fseek(sources[i], sourceOffsets[i], SEEK_SET);
+        fread(block, 1, BLOCK_SIZE, sources[i]);
+        fwrite(block, 1, BLOCK_SIZE, file);
+
+        layout->blockOffset[order[i]] = position;
+        position += BLOCK_SIZE;
+    }
+    free(block);
+
+    fseek(file, 0, SEEK_SET);
+    fwrite(layout, 1, sizeof(Archive), file);
+    fclose(file);
+}
+
+// Pack the loose banks contiguously in authoring order
+void buildOriginalArchive(const char* path)
+{
+    Archive*      layout = (Archive*)calloc(1, sizeof(Archive));
+    FILE*         files[BANK_COUNT];
+    FILE*         sources[MAX_BLOCKS];
+    unsigned int  sourceOffsets[MAX_BLOCKS];
+    unsigned int  order[MAX_BLOCKS];
+
+    memcpy(layout->magic, "FPAK", 4);
+    layout->numEntries = BANK_COUNT;
+
+    for (int i = 0; i < BANK_COUNT; i++)
+    {
+        ArchiveEntry* entry = &layout->entry[i];
+
+        files[i] = fopen(Common_MediaPath(BANK_NAMES[i]), "rb");
+        if (!files[i])
+        {
+            Common_Fatal("Could not open %s", BANK_NAMES[i]);
+        }
+        fseek(files[i], 0, SEEK_END);
+
+        strncpy(entry->name, BANK_NAMES[i], sizeof(entry->name) - 1);
+        entry->size = (unsigned int)ftell(files[i]);
+        entry->firstBlock = layout->numBlocks;
+        entry->numBlocks = (entry->size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+        for (unsigned int b = 0; b < entry->numBlocks; b++)
+        {
+            if (layout->numBlocks == (unsigned int)MAX_BLOCKS)
+            {
+                Common_Fatal("Too many blocks, increase MAX_BLOCKS");
+            }
+            sources[layout->numBlocks] = files[i];
+            sourceOffsets[layout->numBlocks] = b * BLOCK_SIZE;
+            order[layout->numBlocks] = layout->numBlocks;
+            layout->numBlocks++;
+        }
+    }
+
+    writeArchive(path, layout, sources, sourceOffsets, order);
+
+    for (int i = 0; i < BANK_COUNT; i++)
+    {
+        fclose(files[i]);
+    }
+    free(layout);
+}
+
+// Place blocks in order of first read, untouched blocks after them in their original order
+void buildOptimizedArchive(const char* sourcePath, const Archive* source, const char* path, Archive* layout)
+{
+    FILE*         file = fopen(sourcePath, "rb");
+    FILE*         sources[MAX_BLOCKS];
+    unsigned int  sourceOffsets[MAX_BLOCKS];
+    unsigned int  order[MAX_BLOCKS];
+    bool          placed[MAX_BLOCKS] = { false };
+    unsigned int  count = 0;
+
+    if (!file)
+    {
+        Common_Fatal("Could not open %s", sourcePath);
+    }
+
+    *layout = *source;
+
+    for (int i = 0; i < gTrace.count; i++)
+    {
+        const TraceRecord& record = gTrace.record[i];
+        const ArchiveEntry& entry = source->entry[record.entry];
+
+        if (record.size == 0)
+        {
+            continue;
+        }
+
+        for (unsigned int b = record.offset / BLOCK_SIZE; b <= (record.offset + record.size - 1) / BLOCK_SIZE; b++)
+        {
+            unsigned int block = entry.firstBlock + b;
+            if (!placed[block])
+            {
+                placed[block] = true;
+                order[count++] = block;
+            }
+        }
+    }
+    int touched = count;
+
+    for (unsigned int block = 0; block < source->numBlocks; block++)
+    {
+        if (!placed[block])
+        {
+            order[count++] = block;
+        }
+    }
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        sources[i] = file;
+        sourceOffsets[i] = source->blockOffset[order[i]];
+    }
+
+    writeArchive(path, layout, sources, sourceOffsets, order);
+    fclose(file);
+
+    Common_Log("Archive layout: %d of %u blocks touched by the trace\n", touched, source->numBlocks);
+}
+
+//
+// Translate a bank relative read into physical extents of the archive, merging blocks that are adjacent on disk
+//
+template <typename Visitor>
+void forEachExtent(const Archive* archive, int entryIndex, unsigned int offset, unsigned int size, Visitor& visitor)
+{
+    const ArchiveEntry& entry = archive->entry[entryIndex];
+    unsigned int extentStart = 0, extentLength = 0;
+
+    while (size > 0)
+    {
+        unsigned int block = offset / BLOCK_SIZE;
+        unsigned int within = offset % BLOCK_SIZE;
+        unsigned int length = Common_Min(size, BLOCK_SIZE - within);
+        unsigned int physical = archive->blockOffset[entry.firstBlock + block] + within;
+
+        if (extentLength && physical == extentStart + extentLength)
+        {
+            extentLength += length;
+        }
+        else
+        {
+            if (extentLength)
+            {
+                visitor(extentStart, extentLength);
+            }
+            extentStart = physical;
+            extentLength = length;
+        }
+
+        offset += length;
+        size -= length;
+    }
+
+    if (extentLength)
+    {
+        visitor(extentStart, extentLength);
+    }
+}
+
+struct StorageModel
+{
+    const StorageProfile* profile;
+    unsigned int          bufferStart, bufferEnd;     // Data already fetched by the last read plus read-ahead
+    LayoutScore           score;
+
+    void operator()(unsigned int start, unsigned int length)
+    {
+        unsigned int end = start + length;
+
+        if (start >= bufferStart && end <= bufferEnd)
+        {
+            return;     // Served from read-ahead
+        }
+        unsigned int fetchStart;
+        if (start >= bufferStart && start <= bufferEnd)
+        {
+            fetchStart = bufferEnd;     // Continues the previous read, only fetch what is missing
+        }
+        else
+        {
+            score.seeks++;
+            score.ms += profile->seekMs;
+            fetchStart = bufferStart = start;
+        }
+
+        bufferEnd = end + profile->readAhead;
+        score.ms += (bufferEnd - fetchStart) / (profile->megabytesPerSec * 1000.0f);   // 1 MB/s is 1000 bytes per ms
+    }
+};
+
+LayoutScore scoreLayout(const Archive* archive, const StorageProfile* profile)
+{
+    StorageModel model;
+    model.profile = profile;
+    model.bufferStart = model.bufferEnd = 0;
+    model.score.seeks = 0;
+    model.score.ms = 0.0f;
+
+    for (int i = 0; i < gTrace.count; i++)
+    {
+        forEachExtent(archive, gTrace.record[i].entry, gTrace.record[i].offset, gTrace.record[i].size, model);
+    }
+    return model.score;
+}
+
+struct ReplayReader
+{
+    FILE* file;
+    char* buffer;
+
+    void operator()(unsigned int start, unsigned int length)
+    {
+        fseek(file, start, SEEK_SET);
+        while (length > 0)
+        {
+            unsigned int chunk = Common_Min(length, BLOCK_SIZE);
+            fread(buffer, 1, chunk, file);
+            length -= chunk;
+        }
+    }
+};
+
+// Replay the trace against an archive file, returns milliseconds
+float replayTrace(const char* path, const Archive* archive)
+{
+    ReplayReader reader;
+    unsigned int start, end;
+
+    reader.file = fopen(path, "rb");
+    if (!reader.file)
+    {
+        return 0.0f;
+    }
+    reader.buffer = (char*)malloc(BLOCK_SIZE);
+
+    Common_Time_GetUs(&start);
+    for (int i = 0; i < gTrace.count; i++)
+    {
+        forEachExtent(archive, gTrace.record[i].entry, gTrace.record[i].offset, gTrace.record[i].size, reader);
+    }
+    Common_Time_GetUs(&end);
+
+    free(reader.buffer);
+    fclose(reader.file);
+    return (end - start) / 1000.0f;
+}
+
+//
+// Bank file callbacks reading through the archive. The bank info userdata points at a BankSource.
+//
+struct BankSource
+{
+    const char*    path;
+    const Archive* archive;
+    int            entry;
+};
+
+struct ArchiveHandle
+{
+    FILE*        file;
+    BankSource*  source;
+    unsigned int position;
+};
+
+struct ArchiveReader
+{
+    ArchiveHandle* handle;
+    char*          buffer;
+    unsigned int   read;
+
+    void operator()(unsigned int start, unsigned int length)
+    {
+        fseek(handle->file, start, SEEK_SET);
+        read += (unsigned int)fread(buffer + read, 1, length, handle->file);
+    }
+};
+
+FMOD_RESULT F_CALL archiveFileOpen(const char * /*name*/, unsigned int *filesize, void **handle, void *userdata)
+{
+    BankSource* source = (BankSource*)userdata;
+    FILE* file = fopen(source->path, "rb");
+    if (!file)
+    {
+        return FMOD_ERR_FILE_NOTFOUND;
+    }
+
+    ArchiveHandle* archiveHandle = (ArchiveHandle*)malloc(sizeof(ArchiveHandle));
+    archiveHandle->file = file;
+    archiveHandle->source = source;
+    archiveHandle->position = 0;
+
+    *filesize = source->archive->entry[source->entry].size;
+    *handle = archiveHandle;
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL archiveFileClose(void *handle, void * /*userdata*/)
+{
+    ArchiveHandle* archiveHandle = (ArchiveHandle*)handle;
+    fclose(archiveHandle->file);
+    free(archiveHandle);
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALL archiveFileRead(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread, void * /*userdata*/)
+{
+    ArchiveHandle* archiveHandle = (ArchiveHandle*)handle;
+    const ArchiveEntry& entry = archiveHandle->source->archive->entry[archiveHandle->source->entry];
+    unsigned int size = sizebytes;
+
+    *bytesread = 0;
+    if (archiveHandle->position >= entry.size)
+    {
+        return FMOD_ERR_FILE_EOF;
+    }
+    if (size > entry.size - archiveHandle->position)
+    {
+        size = entry.size - archiveHandle->position;
+    }
+
+    Common_Mutex_Enter(&gTrace.lock);
+    if (gTrace.recording && gTrace.count < MAX_TRACE)
+    {
+        TraceRecord& record = gTrace.record[gTrace.count++];
+        record.entry = archiveHandle->source->entry;
+        record.offset = archiveHandle->position;
+        record.size = size;
+    }
+    Common_Mutex_Leave(&gTrace.lock);
+
+    ArchiveReader reader;
+    reader.handle = archiveHandle;
+    reader.buffer = (char*)buffer;
+    reader.read = 0;
+    forEachExtent(archiveHandle->source->archive, archiveHandle->source->entry, archiveHandle->position, size, reader);
+
+    archiveHandle->position += reader.read;
+    *bytesread = reader.read;
+
+    // If the request is larger than the bytes left in the file, then we must return EOF
+    return (reader.read < sizebytes) ? FMOD_ERR_FILE_EOF : FMOD_OK;
+}
+
+FMOD_RESULT F_CALL archiveFileSeek(void *handle, unsigned int pos, void * /*userdata*/)
+{
+    ArchiveHandle* archiveHandle = (ArchiveHandle*)handle;
+    archiveHandle->position = pos;
+    return FMOD_OK;
+}
+
+//
+// Level load: banks in load order, sample data, then start the streaming events
+//
+void loadLevel(FMOD::Studio::System* system, BankSource* sources, FMOD::Studio::EventInstance** instances)
+{
+    for (int i = 0; i < LOAD_COUNT; i++)
+    {
+        FMOD_STUDIO_BANK_INFO info;
+        memset(&info, 0, sizeof(info));
+        info.size = sizeof(info);
+        info.opencallback = archiveFileOpen;
+        info.closecallback = archiveFileClose;
+        info.readcallback = archiveFileRead;
+        info.seekcallback = archiveFileSeek;
+        info.userdata = &sources[LOAD_ORDER[i]];
+
+        FMOD::Studio::Bank* bank = NULL;
+        ERRCHECK( system->loadBankCustom(&info, FMOD_STUDIO_LOAD_BANK_NORMAL, &bank) );
+        ERRCHECK( bank->loadSampleData() );
+    }
+    ERRCHECK( system->flushSampleLoading() );
+
+    for (int i = 0; i < EVENT_COUNT; i++)
+    {
+        FMOD::Studio::EventDescription* description = NULL;
+        ERRCHECK( system->getEvent(EVENT_NAMES[i], &description) );
+        ERRCHECK( description->createInstance(&instances[i]) );
+        ERRCHECK( instances[i]->start() );
+    }
+}
+
+void unloadLevel(FMOD::Studio::System* system, FMOD::Studio::EventInstance** instances)
+{
+    for (int i = 0; i < EVENT_COUNT; i++)
+    {
+        if (instances[i])
+        {
+            ERRCHECK( instances[i]->stop(FMOD_STUDIO_STOP_IMMEDIATE) );
+            ERRCHECK( instances[i]->release() );
+            instances[i] = NULL;
+        }
+    }
+    ERRCHECK( system->unloadAll() );
+    ERRCHECK( system->flushCommands() );
+}
+
+//
+// Main example code
+//
+int FMOD_Main()
+{
+    void *extraDriverData = NULL;
+    Common_Init(&extraDriverData);
+
+    FMOD::Studio::System* system = NULL;
+    ERRCHECK( FMOD::Studio::System::create(&system) );
+
+    // The example Studio project is authored for 5.1 sound, so set up the system output mode to match
+    FMOD::System* coreSystem = NULL;
+    ERRCHECK( system->getCoreSystem(&coreSystem) );
+    ERRCHECK( coreSystem->setSoftwareFormat(0, FMOD_SPEAKERMODE_5POINT1, 0) );
+
+    ERRCHECK( system->initialize(1024, FMOD_STUDIO_INIT_NORMAL, FMOD_INIT_NORMAL, extraDriverData) );
+
+    // Common_WritePath returns a new string per call, keep the paths
+    const char* archivePath[2] = { Common_WritePath("banks_original.pak"), Common_WritePath("banks_optimized.pak") };
+    Archive* archive[2] = { (Archive*)calloc(1, sizeof(Archive)), (Archive*)calloc(1, sizeof(Archive)) };
+    bool haveOptimized = false;
+
+    if (!readArchive(archivePath[0], archive[0]))
+    {
+        buildOriginalArchive(archivePath[0]);
+        if (!readArchive(archivePath[0], archive[0]))
+        {
+            Common_Fatal("Could not read %s", archivePath[0]);
+        }
+    }
+
+    BankSource sources[2][BANK_COUNT];
+    for (int layout = 0; layout < 2; layout++)
+    {
+        for (int i = 0; i < BANK_COUNT; i++)
+        {
+            sources[layout][i].path = archivePath[layout];
+            sources[layout][i].archive = archive[layout];
+            sources[layout][i].entry = i;
+        }
+    }
+
+    Common_Mutex_Create(&gTrace.lock);
+    gTrace.count = 0;
+    gTrace.recording = true;
+
+    FMOD::Studio::EventInstance* instances[EVENT_COUNT] = { NULL };
+    int playingLayout = 0;
+    unsigned int levelStart;
+
+    loadLevel(system, sources[playingLayout], instances);
+    Common_Time_GetUs(&levelStart);
+
+    LayoutScore score[2][PROFILE_COUNT];
+    float replayMs[2] = { 0.0f, 0.0f };
+    memset(score, 0, sizeof(score));
+
+    do
+    {
+        Common_Update();
+
+        unsigned int now;
+        Common_Time_GetUs(&now);
+
+        // Stop recording once the level has played for a while, the gameplay reads are part of the trace
+        if (gTrace.recording && now - levelStart > GAMEPLAY_MS * 1000)
+        {
+            Common_Mutex_Enter(&gTrace.lock);
+            gTrace.recording = false;
+            Common_Mutex_Leave(&gTrace.lock);
+
+            for (int p = 0; p < PROFILE_COUNT; p++)
+            {
+                score[0][p] = scoreLayout(archive[0], &STORAGE_PROFILES[p]);
+            }
+        }
+
+        if (!gTrace.recording && Common_BtnPress(BTN_ACTION1))
+        {
+            // The playing level may read from the optimized archive, so go back to the original while rewriting it
+            if (playingLayout == 1)
+            {
+                unloadLevel(system, instances);
+                playingLayout = 0;
+                loadLevel(system, sources[playingLayout], instances);
+            }
+
+            buildOptimizedArchive(archivePath[0], archive[0], archivePath[1], archive[1]);
+            haveOptimized = true;
+
+            for (int p = 0; p < PROFILE_COUNT; p++)
+            {
+                score[1][p] = scoreLayout(archive[1], &STORAGE_PROFILES[p]);
+            }
+        }
+
+        if (!gTrace.recording && Common_BtnPress(BTN_ACTION2))
+        {
+            for (int layout = 0; layout < (haveOptimized ? 2 : 1); layout++)
+            {
+                replayMs[layout] = replayTrace(archivePath[layout], archive[layout]);
+            }
+        }
+
+        if (haveOptimized && Common_BtnPress(BTN_ACTION3))
+        {
+            // Reload the level from the other archive to check both play the same
+            unloadLevel(system, instances);
+            playingLayout = 1 - playingLayout;
+            loadLevel(system, sources[playingLayout], instances);
+        }
+
+        ERRCHECK( system->update() );
+
+        Common_Draw("==================================================");
+        Common_Draw("Archive Layout Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2012-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("");
+        if (gTrace.recording)
+        {
+            Common_Draw("Recording level load and gameplay...");
+            Common_Draw("Reads traced : %d", gTrace.count);
+        }
+        else
+        {
+            Common_Draw("Press %s to build the optimized archive", Common_BtnStr(BTN_ACTION1));
+            Common_Draw("Press %s to run the replay benchmark", Common_BtnStr(BTN_ACTION2));
+            if (haveOptimized)
+            {
+                Common_Draw("Press %s to reload the level from the other archive", Common_BtnStr(BTN_ACTION3));
+            }
+            Common_Draw("");
+            Common_Draw("Reads traced : %d, playing from %s archive", gTrace.count, playingLayout ? "optimized" : "original");
+            Common_Draw("");
+            Common_Draw("Estimate       Original        Optimized");
+            for (int p = 0; p < PROFILE_COUNT; p++)
+            {
+                Common_Draw("%s", STORAGE_PROFILES[p].name);
+                if (haveOptimized)
+                {
+                    Common_Draw("  %5d seeks %6.0f ms  %5d seeks %6.0f ms", score[0][p].seeks, score[0][p].ms, score[1][p].seeks, score[1][p].ms);
+                }
+                else
+                {
+                    Common_Draw("  %5d seeks %6.0f ms  -", score[0][p].seeks, score[0][p].ms);
+                }
+            }
+            Common_Draw("");
+            Common_Draw("Replay       : %8.1f ms  %8.1f ms", replayMs[0], replayMs[1]);
+        }
+        Common_Draw("");
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+
+        Common_Sleep(50);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    unloadLevel(system, instances);
+    ERRCHECK( system->release() );
+
+    Common_Mutex_Destroy(&gTrace.lock);
+    free(archive[0]);
+    free(archive[1]);
+
+    Common_Close();
+
+    return 0;
+}
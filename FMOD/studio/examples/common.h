@@ -69,6 +69,7 @@ void Common_Mutex_Destroy(Common_Mutex *mutex);
 void Common_Mutex_Enter(Common_Mutex *mutex);
 void Common_Mutex_Leave(Common_Mutex *mutex);
 void Common_Thread_Create(void (*callback)(void *param), void *param, void **handle);
+void Common_Thread_Create(void (*callback)(void *param), void *param, FMOD_THREAD_AFFINITY affinity, FMOD_THREAD_PRIORITY priority, FMOD_THREAD_STACK_SIZE stacksize, void **handle);
 void Common_Thread_Destroy(void *handle);
 
 void ERRCHECK_fn(FMOD_RESULT result, const char *file, int line);
@@ -0,0 +1,471 @@
+/*==============================================================================
+Locale Switch Example
+Copyright (c), Firelight Technologies Pty, Ltd 2012-2025.
+
+This example demonstrates switching the language of programmer sound
+dialogue without stalling the main thread or cutting off lines that are
+already playing.
+
+The Programmer Sound example unloads the localized bank and loads the new one
+with a blocking Studio::System::loadBankFile. Here a small locale service
+does the switch in the background:
+
+* Programmer sounds are resolved from a table of audio table entries copied
+  out of the localized bank once it has loaded, rather than straight from the
+  bank. The table for the current language keeps serving new lines while the
+  next language loads.
+* The new bank is loaded with FMOD_STUDIO_LOAD_BANK_NONBLOCKING. Localized
+  variants of a bank share its GUID, so the old variant is unloaded first,
+  the copied table does not need it.
+* When the new bank reports FMOD_STUDIO_LOADING_STATE_LOADED its table is
+  built and swapped in under the service lock, so every programmer sound is
+  created entirely from one language.
+* The old table is freed only after the last programmer sound created from it
+  has been destroyed.
+
+The main thread cost of a switch is shown next to the blocking switch from
+the Programmer Sound example for comparison.
+
+### See Also ###
+* Studio::EventInstance::setCallback
+* Studio::System::getSoundInfo
+* Studio::Bank::getLoadingState
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod_studio.hpp"
+#include "fmod.hpp"
+#include "common.h"
+
+static const int MAX_KEYS       = 8;
+static const int MAX_TABLES     = 4;
+static const int MAX_SOUNDS     = 32;
+
+static const char* const BANK_NAMES[] = { "Dialogue_EN.bank", "Dialogue_JP.bank", "Dialogue_CN.bank" };
+static const char* const LANGUAGE_NAMES[] = { "English", "Japanese", "Chinese" };
+
+// Dialogue keys available
+// These keys are shared amongst all audio tables
+static const char* const DIALOGUE_KEYS[] = { "welcome", "main menu", "goodbye" };
+static const int DIALOGUE_KEY_COUNT = sizeof(DIALOGUE_KEYS) / sizeof(DIALOGUE_KEYS[0]);
+
+//
+// Audio table entries of one language. FMOD_STUDIO_SOUND_INFO::name_or_data belongs to the bank, so the path
+// is copied and the table stays usable after the bank is unloaded.
+//
+struct LocaleTable
+{
+    int                     language;
+    FMOD_STUDIO_SOUND_INFO  info[MAX_KEYS];
+    char                    path[MAX_KEYS][256];
+    int                     liveSounds;         // Programmer sounds created from this table and not yet destroyed
+};
+
+struct LiveSound
+{
+    FMOD::Sound*            sound;
+    LocaleTable*            table;
+};
+
+struct LocaleService
+{
+    FMOD::Studio::System*   system;
+    Common_Mutex            lock;               // Guards everything below, programmer sound callbacks run on the Studio update thread
+
+    LocaleTable*            active;
+    LocaleTable*            retired[MAX_TABLES];
+    int                     numRetired;
+    LiveSound               live[MAX_SOUNDS];
+    int                     numLive;
+
+    FMOD::Studio::Bank*     bank;
+    FMOD::Studio::Bank*     pendingBank;
+    int                     pendingLanguage;    // -1 when no switch is in flight
+    unsigned int            switchStart;
+
+    float                   lastCallMs;         // Main thread time spent starting the last switch
+    float                   lastSwitchMs;       // Time until the new language was serving
+    bool                    lastBlocking;
+};
+
+struct ProgrammerSoundContext
+{
+    LocaleService*          service;
+    const char*             dialogueString;
+};
+
+FMOD_RESULT F_CALL programmerSoundCallback(FMOD_STUDIO_EVENT_CALLBACK_TYPE type, FMOD_STUDIO_EVENTINSTANCE* event, void *parameters);
+
+//
+// Copy the audio table entries of the loaded localized bank
+//
+LocaleTable* buildTable(FMOD::Studio::System* system, int language)
+{
+    LocaleTable* table = (LocaleTable*)calloc(1, sizeof(LocaleTable));
+    table->language = language;
+
+    for (int i = 0; i < DIALOGUE_KEY_COUNT; i++)
+    {
+        ERRCHECK( system->getSoundInfo(DIALOGUE_KEYS[i], &table->info[i]) );
+
+        strncpy(table->path[i], table->info[i].name_or_data, sizeof(table->path[i]) - 1);
+        table->info[i].name_or_data = table->path[i];
+    }
+    return table;
+}
+
+void retireTable(LocaleService* service, LocaleTable* table)
+{
+    if (service->numRetired == MAX_TABLES)
+    {
+        Common_Fatal("Too many languages waiting for their dialogue to finish");
+    }
+    service->retired[service->numRetired++] = table;
+}
+
+void initService(LocaleService* service, FMOD::Studio::System* system, int language)
+{
+    memset(service, 0, sizeof(LocaleService));
+    service->system = system;
+    service->pendingLanguage = -1;
+    Common_Mutex_Create(&service->lock);
+
+    ERRCHECK( system->loadBankFile(Common_MediaPath(BANK_NAMES[language]), FMOD_STUDIO_LOAD_BANK_NORMAL, &service->bank) );
+    service->active = buildTable(system, language);
+}
+
+void releaseService(LocaleService* service)
+{
+    free(service->active);
+    for (int i = 0; i < service->numRetired; i++)
+    {
+        free(service->retired[i]);
+    }
+    Common_Mutex_Destroy(&service->lock);
+}
+
+int currentLanguage(LocaleService* service)
+{
+    return service->pendingLanguage >= 0 ? service->pendingLanguage : service->active->language;
+}
+
+//
+// Start a switch. The active table keeps serving until the new bank has loaded.
+//
+void requestLanguage(LocaleService* service, int language)
+{
+    if (service->pendingLanguage >= 0 || language == service->active->language)
+    {
+        return;
+    }
+
+    unsigned int start, end;
+    Common_Time_GetUs(&start);
+
+    // Localized variants share a GUID, the old one has to go before the new one can load. Until the new bank has
+    // loaded the service has no bank, a failed load leaves it that way.
+    if (service->bank)
+    {
+        ERRCHECK( service->bank->unload() );
+        service->bank = NULL;
+    }
+    ERRCHECK( service->system->loadBankFile(Common_MediaPath(BANK_NAMES[language]), FMOD_STUDIO_LOAD_BANK_NONBLOCKING, &service->pendingBank) );
+    service->pendingLanguage = language;
+    service->switchStart = start;
+
+    Common_Time_GetUs(&end);
+    service->lastCallMs = (end - start) / 1000.0f;
+    service->lastBlocking = false;
+}
+
+// The Programmer Sound example's switch, for comparison
+void switchLanguageBlocking(LocaleService* service, int language)
+{
+    if (service->pendingLanguage >= 0)
+    {
+        return;
+    }
+
+    unsigned int start, end;
+    Common_Time_GetUs(&start);
+
+    if (service->bank)
+    {
+        ERRCHECK( service->bank->unload() );
+        service->bank = NULL;
+    }
+    ERRCHECK( service->system->loadBankFile(Common_MediaPath(BANK_NAMES[language]), FMOD_STUDIO_LOAD_BANK_NORMAL, &service->bank) );
+    LocaleTable* table = buildTable(service->system, language);
+
+    Common_Mutex_Enter(&service->lock);
+    retireTable(service, service->active);
+    service->active = table;
+    Common_Mutex_Leave(&service->lock);
+
+    Common_Time_GetUs(&end);
+    service->lastCallMs = service->lastSwitchMs = (end - start) / 1000.0f;
+    service->lastBlocking = true;
+}
+
+//
+// Called once per frame: completes a pending switch and frees tables nothing plays from any more
+//
+void updateService(LocaleService* service)
+{
+    if (service->pendingLanguage >= 0)
+    {
+        // In the error state the result is the reason the load failed
+        FMOD_STUDIO_LOADING_STATE state;
+        FMOD_RESULT loadResult = service->pendingBank->getLoadingState(&state);
+
+        if (state == FMOD_STUDIO_LOADING_STATE_LOADED)
+        {
+            LocaleTable* table = buildTable(service->system, service->pendingLanguage);
+
+            Common_Mutex_Enter(&service->lock);
+            retireTable(service, service->active);
+            service->active = table;
+            Common_Mutex_Leave(&service->lock);
+
+            service->bank = service->pendingBank;
+            service->pendingBank = NULL;
+            service->pendingLanguage = -1;
+
+            unsigned int now;
+            Common_Time_GetUs(&now);
+            service->lastSwitchMs = (now - service->switchStart) / 1000.0f;
+        }
+        else if (state == FMOD_STUDIO_LOADING_STATE_ERROR)
+        {
+            // The bank could not be loaded, stay on the current language. The old bank is already unloaded (service->bank
+            // is NULL until the next switch) but its table still works.
+            Common_Log("Locale switch to %s failed (%d)\n", LANGUAGE_NAMES[service->pendingLanguage], loadResult);
+            ERRCHECK( service->pendingBank->unload() );
+            service->pendingBank = NULL;
+            service->pendingLanguage = -1;
+        }
+    }
+
+    Common_Mutex_Enter(&service->lock);
+    for (int i = 0; i < service->numRetired; )
+    {
+        if (service->retired[i]->liveSounds == 0)
+        {
+            free(service->retired[i]);
+            service->retired[i] = service->retired[--service->numRetired];
+        }
+        else
+        {
+            i++;
+        }
+    }
+    Common_Mutex_Leave(&service->lock);
+}
+
+int retiredSoundCount(LocaleService* service)
+{
+    int count = 0;
+    Common_Mutex_Enter(&service->lock);
+    for (int i = 0; i < service->numRetired; i++)
+    {
+        count += service->retired[i]->liveSounds;
+    }
+    Common_Mutex_Leave(&service->lock);
+    return count;
+}
+
+int FMOD_Main()
+{
+    void *extraDriverData = NULL;
+    Common_Init(&extraDriverData);
+
+    FMOD::Studio::System* system = NULL;
+    ERRCHECK( FMOD::Studio::System::create(&system) );
+
+    // The example Studio project is authored for 5.1 sound, so set up the system output mode to match
+    FMOD::System* coreSystem = NULL;
+    ERRCHECK( system->getCoreSystem(&coreSystem) );
+    ERRCHECK( coreSystem->setSoftwareFormat(0, FMOD_SPEAKERMODE_5POINT1, 0) );
+
+    ERRCHECK( system->initialize(1024, FMOD_STUDIO_INIT_NORMAL, FMOD_INIT_NORMAL, extraDriverData) );
+
+    FMOD::Studio::Bank* masterBank = NULL;
+    ERRCHECK( system->loadBankFile(Common_MediaPath("Master.bank"), FMOD_STUDIO_LOAD_BANK_NORMAL, &masterBank) );
+
+    FMOD::Studio::Bank* stringsBank = NULL;
+    ERRCHECK( system->loadBankFile(Common_MediaPath("Master.strings.bank"), FMOD_STUDIO_LOAD_BANK_NORMAL, &stringsBank) );
+
+    FMOD::Studio::Bank* sfxBank = NULL;
+    ERRCHECK( system->loadBankFile(Common_MediaPath("SFX.bank"), FMOD_STUDIO_LOAD_BANK_NORMAL, &sfxBank) );
+
+    LocaleService service;
+    initService(&service, system, 0);
+
+    FMOD::Studio::EventDescription* eventDescription = NULL;
+    ERRCHECK( system->getEvent("event:/Character/Dialogue", &eventDescription) );
+
+    unsigned int dialogueIndex = 0;
+    ProgrammerSoundContext programmerSoundContext;
+    programmerSoundContext.service = &service;
+    programmerSoundContext.dialogueString = DIALOGUE_KEYS[dialogueIndex];
+
+    do
+    {
+        Common_Update();
+
+        if (Common_BtnPress(BTN_ACTION1))
+        {
+            requestLanguage(&service, (currentLanguage(&service) + 1) % 3);
+        }
+
+        if (Common_BtnPress(BTN_ACTION2))
+        {
+            switchLanguageBlocking(&service, (currentLanguage(&service) + 1) % 3);
+        }
+
+        if (Common_BtnPress(BTN_ACTION3))
+        {
+            dialogueIndex = (dialogueIndex < 2) ? dialogueIndex + 1 : 0;
+            programmerSoundContext.dialogueString = DIALOGUE_KEYS[dialogueIndex];
+        }
+
+        if (Common_BtnPress(BTN_MORE))
+        {
+            // One instance per line so lines can overlap a language switch
+            FMOD::Studio::EventInstance* eventInstance = NULL;
+            ERRCHECK( eventDescription->createInstance(&eventInstance) );
+            ERRCHECK( eventInstance->setUserData(&programmerSoundContext) );
+            ERRCHECK( eventInstance->setCallback(programmerSoundCallback, FMOD_STUDIO_EVENT_CALLBACK_CREATE_PROGRAMMER_SOUND | FMOD_STUDIO_EVENT_CALLBACK_DESTROY_PROGRAMMER_SOUND) );
+            ERRCHECK( eventInstance->start() );
+            ERRCHECK( eventInstance->release() );
+        }
+
+        updateService(&service);
+
+        ERRCHECK( system->update() );
+
+        Common_Draw("==================================================");
+        Common_Draw("Locale Switch Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2012-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("");
+        Common_Draw("Press %s to change language (background)", Common_BtnStr(BTN_ACTION1));
+        Common_Draw("Press %s to change language (blocking)", Common_BtnStr(BTN_ACTION2));
+        Common_Draw("Press %s to change dialogue", Common_BtnStr(BTN_ACTION3));
+        Common_Draw("Press %s to play a line",  Common_BtnStr(BTN_MORE));
+        Common_Draw("");
+        Common_Draw("Language:");
+        for (int i = 0; i < 3; i++)
+        {
+            Common_Draw("  %s %-9s %s", service.active->language == i ? ">" : " ", LANGUAGE_NAMES[i], service.pendingLanguage == i ? "(loading)" : "");
+        }
+        Common_Draw("");
+        Common_Draw("Dialogue: %s", DIALOGUE_KEYS[dialogueIndex]);
+        Common_Draw("");
+        Common_Draw("Last switch (%s)", service.lastBlocking ? "blocking" : "background");
+        Common_Draw("  Main thread : %6.1f ms", service.lastCallMs);
+        Common_Draw("  Until live  : %6.1f ms", service.lastSwitchMs);
+        Common_Draw("Old language lines still playing : %d", retiredSoundCount(&service));
+        Common_Draw("");
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+
+        Common_Sleep(50);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    ERRCHECK( system->release() );
+    releaseService(&service);
+
+    Common_Close();
+
+    return 0;
+}
+
+#define CHECK_RESULT(op) \
+    { \
+        FMOD_RESULT res = (op); \
+        if (res != FMOD_OK) \
+        { \
+            return res; \
+        } \
+    }
+
+FMOD_RESULT F_CALL programmerSoundCallback(FMOD_STUDIO_EVENT_CALLBACK_TYPE type, FMOD_STUDIO_EVENTINSTANCE* event, void *parameters)
+{
+    FMOD::Studio::EventInstance* eventInstance = (FMOD::Studio::EventInstance*)event;
+
+    if (type == FMOD_STUDIO_EVENT_CALLBACK_CREATE_PROGRAMMER_SOUND)
+    {
+        FMOD_STUDIO_PROGRAMMER_SOUND_PROPERTIES* props = (FMOD_STUDIO_PROGRAMMER_SOUND_PROPERTIES*)parameters;
+
+        // Get our context from the event instance user data
+        ProgrammerSoundContext* context = NULL;
+        CHECK_RESULT( eventInstance->getUserData((void**)&context) );
+        LocaleService* service = context->service;
+
+        FMOD::Studio::System* studioSystem = NULL;
+        CHECK_RESULT( eventInstance->getSystem(&studioSystem) );
+        FMOD::System* coreSystem = NULL;
+        CHECK_RESULT( studioSystem->getCoreSystem(&coreSystem) );
+
+        // Resolve the key against the active table, the whole line comes from one language
+        Common_Mutex_Enter(&service->lock);
+        LocaleTable* table = service->active;
+        int key = 0;
+        while (key < DIALOGUE_KEY_COUNT && strcmp(DIALOGUE_KEYS[key], context->dialogueString) != 0)
+        {
+            key++;
+        }
+
+        FMOD_RESULT result = FMOD_ERR_EVENT_NOTFOUND;
+        FMOD::Sound* sound = NULL;
+        if (key < DIALOGUE_KEY_COUNT && service->numLive < MAX_SOUNDS)
+        {
+            FMOD_STUDIO_SOUND_INFO info = table->info[key];
+            result = coreSystem->createSound(info.name_or_data, FMOD_LOOP_NORMAL | FMOD_CREATECOMPRESSEDSAMPLE | FMOD_NONBLOCKING | info.mode, &info.exinfo, &sound);
+            if (result == FMOD_OK)
+            {
+                service->live[service->numLive].sound = sound;
+                service->live[service->numLive].table = table;
+                service->numLive++;
+                table->liveSounds++;
+
+                // Pass the sound to FMOD
+                props->sound = (FMOD_SOUND*)sound;
+                props->subsoundIndex = info.subsoundindex;
+            }
+        }
+        Common_Mutex_Leave(&service->lock);
+
+        return result;
+    }
+    else if (type == FMOD_STUDIO_EVENT_CALLBACK_DESTROY_PROGRAMMER_SOUND)
+    {
+        FMOD_STUDIO_PROGRAMMER_SOUND_PROPERTIES* props = (FMOD_STUDIO_PROGRAMMER_SOUND_PROPERTIES*)parameters;
+
+        ProgrammerSoundContext* context = NULL;
+        CHECK_RESULT( eventInstance->getUserData((void**)&context) );
+        LocaleService* service = context->service;
+
+        // Obtain the sound
+        FMOD::Sound* sound = (FMOD::Sound*)props->sound;
+
+        // The table the sound came from can be freed once this was its last sound
+        Common_Mutex_Enter(&service->lock);
+        for (int i = 0; i < service->numLive; i++)
+        {
+            if (service->live[i].sound == sound)
+            {
+                service->live[i].table->liveSounds--;
+                service->live[i] = service->live[--service->numLive];
+                break;
+            }
+        }
+        Common_Mutex_Leave(&service->lock);
+
+        // Release the sound
+        CHECK_RESULT( sound->release() );
+    }
+
+    return FMOD_OK;
+}
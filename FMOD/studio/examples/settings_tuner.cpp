@@ -0,0 +1,425 @@
+/*==============================================================================
+Studio Settings Tuner Example
+Copyright (c), Firelight Technologies Pty, Ltd 2012-2025.
+
+This example demonstrates sizing FMOD_STUDIO_ADVANCEDSETTINGS from the
+buffer usage counters instead of by hand.
+
+A command capture is replayed in real time once per candidate setting. The
+capture written by the Recording and Playback example (playback.cmd.txt) is
+used if it exists, otherwise a short scripted session with bursts of one-shot
+events is captured first. After each replay Studio::System::getBufferUsage
+gives the peak usage and stall count of the command queue and the handle
+table:
+
+* Any stall doubles the stalled buffer and the replay is run again. If the
+  command queue is already at its limit the update period is halved
+  instead, so the Studio update thread drains the queue more often.
+* Once a replay runs without stalls, the sizes are shrunk to the recorded
+  peak plus a margin and verified with one more replay.
+
+The zero stall candidate with the smallest memory footprint, measured with
+Memory_GetStats around Studio::System::initialize, is written to a profile
+named after the platform, to be applied with
+Studio::System::setAdvancedSettings before initialize. The idle sample data
+pool and the streaming schedule delay are not covered by the counters and
+are written out at their defaults.
+
+### See Also ###
+* Studio::System::getBufferUsage
+* Studio::System::loadCommandReplay
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod_studio.hpp"
+#include "fmod.hpp"
+#include "common.h"
+
+#if defined(_WIN64)
+    #define TUNER_PLATFORM "win64"
+#elif defined(_WIN32)
+    #define TUNER_PLATFORM "win32"
+#elif defined(__ANDROID__)
+    #define TUNER_PLATFORM "android"
+#elif defined(__APPLE__)
+    #define TUNER_PLATFORM "apple"
+#elif defined(__linux__)
+    #define TUNER_PLATFORM "linux"
+#else
+    #define TUNER_PLATFORM "unknown"
+#endif
+
+static const char* RECORDED_CAPTURE = "playback.cmd.txt";
+static const char* SCRIPTED_CAPTURE = "settings_tuner.cmd.txt";
+
+const int MAX_TRIALS = 10;
+const int MARGIN_PERCENT = 25;                  // Headroom on top of the recorded peak
+const unsigned int QUEUE_GRANULARITY = 1024;    // Command queue is sized in bytes
+const unsigned int QUEUE_MIN = 4 * 1024;
+const unsigned int QUEUE_MAX = 1024 * 1024;
+const unsigned int HANDLE_GRANULARITY = 64;     // Handle table is sized in handles
+const int UPDATE_PERIOD_MIN = 5;
+
+const int SCRIPT_FRAMES = 160;                  // 8 seconds at 50 ms
+const int SCRIPT_BURST_INTERVAL = 20;
+const int SCRIPT_BURST_SIZE = 48;
+
+struct Trial
+{
+    FMOD_STUDIO_ADVANCEDSETTINGS    settings;
+    FMOD_STUDIO_BUFFER_USAGE        usage;
+    int                             memory;     // Bytes allocated by Studio::System::initialize
+    const char*                     reason;
+};
+
+unsigned int roundUp(unsigned int value, unsigned int granularity)
+{
+    return (value + granularity - 1) / granularity * granularity;
+}
+
+bool fileExists(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (file)
+    {
+        fclose(file);
+        return true;
+    }
+    return false;
+}
+
+void drawHeader()
+{
+    Common_Draw("==================================================");
+    Common_Draw("Studio Settings Tuner Example.");
+    Common_Draw("Copyright (c) Firelight Technologies 2012-2025.");
+    Common_Draw("==================================================");
+    Common_Draw("");
+}
+
+FMOD::Studio::System* createSystem(FMOD_STUDIO_ADVANCEDSETTINGS* settings, int* memory, void* extraDriverData)
+{
+    FMOD::Studio::System* system = NULL;
+    ERRCHECK( FMOD::Studio::System::create(&system) );
+
+    // The example Studio project is authored for 5.1 sound, so set up the system output mode to match
+    FMOD::System* coreSystem = NULL;
+    ERRCHECK( system->getCoreSystem(&coreSystem) );
+    ERRCHECK( coreSystem->setSoftwareFormat(0, FMOD_SPEAKERMODE_5POINT1, 0) );
+
+    if (settings)
+    {
+        ERRCHECK( system->setAdvancedSettings(settings) );
+    }
+
+    int before = 0, after = 0;
+    ERRCHECK( FMOD::Memory_GetStats(&before, NULL) );
+    ERRCHECK( system->initialize(1024, FMOD_STUDIO_INIT_NORMAL, FMOD_INIT_NORMAL, extraDriverData) );
+    ERRCHECK( FMOD::Memory_GetStats(&after, NULL) );
+
+    if (memory)
+    {
+        *memory = after - before;
+    }
+    return system;
+}
+
+// Capture a busy session: an engine with a parameter sweep plus regular bursts of one-shots, each with a
+// handful of property changes, the kind of frame that fills the command queue and the handle table
+bool recordScript(const char* capturePath, void* extraDriverData)
+{
+    FMOD::Studio::System* system = createSystem(NULL, NULL, extraDriverData);
+
+    FMOD::Studio::Bank* bank = NULL;
+    ERRCHECK( system->loadBankFile(Common_MediaPath("Master.bank"), FMOD_STUDIO_LOAD_BANK_NORMAL, &bank) );
+    ERRCHECK( system->loadBankFile(Common_MediaPath("Master.strings.bank"), FMOD_STUDIO_LOAD_BANK_NORMAL, &bank) );
+    ERRCHECK( system->loadBankFile(Common_MediaPath("SFX.bank"), FMOD_STUDIO_LOAD_BANK_NORMAL, &bank) );
+    ERRCHECK( system->loadBankFile(Common_MediaPath("Vehicles.bank"), FMOD_STUDIO_LOAD_BANK_NORMAL, &bank) );
+
+    ERRCHECK( system->startCommandCapture(capturePath, FMOD_STUDIO_COMMANDCAPTURE_NORMAL) );
+
+    FMOD::Studio::EventDescription* explosionDescription = NULL;
+    ERRCHECK( system->getEvent("event:/Weapons/Explosion", &explosionDescription) );
+
+    FMOD::Studio::EventDescription* engineDescription = NULL;
+    ERRCHECK( system->getEvent("event:/Vehicles/Ride-on Mower", &engineDescription) );
+
+    FMOD::Studio::EventInstance* engineInstance = NULL;
+    ERRCHECK( engineDescription->createInstance(&engineInstance) );
+    ERRCHECK( engineInstance->start() );
+
+    bool quit = false;
+    for (int frame = 0; frame < SCRIPT_FRAMES && !quit; frame++)
+    {
+        Common_Update();
+        quit = Common_BtnPress(BTN_QUIT);
+
+        ERRCHECK( engineInstance->setParameterByName("RPM", 650.0f + (frame % 40) * 100.0f) );
+
+        int oneShots = (frame % SCRIPT_BURST_INTERVAL == 0) ? SCRIPT_BURST_SIZE : 1;
+        for (int i = 0; i < oneShots; i++)
+        {
+            FMOD::Studio::EventInstance* instance = NULL;
+            ERRCHECK( explosionDescription->createInstance(&instance) );
+            for (int j = 0; j < 8; j++)
+            {
+                ERRCHECK( instance->setVolume(0.1f + j * 0.01f) );
+            }
+            ERRCHECK( instance->start() );
+            ERRCHECK( instance->release() );
+        }
+
+        ERRCHECK( system->update() );
+
+        drawHeader();
+        Common_Draw("Recording a scripted session to %s", SCRIPTED_CAPTURE);
+        Common_Draw("Frame %d / %d", frame + 1, SCRIPT_FRAMES);
+        Common_Draw("");
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+
+        Common_Sleep(50);
+    }
+
+    ERRCHECK( engineInstance->stop(FMOD_STUDIO_STOP_IMMEDIATE) );
+    ERRCHECK( engineInstance->release() );
+    ERRCHECK( system->unloadAll() );
+    ERRCHECK( system->flushCommands() );
+    ERRCHECK( system->stopCommandCapture() );
+    ERRCHECK( system->release() );
+
+    return !quit;
+}
+
+// Replay the capture in real time with the trial's settings and collect the buffer usage
+bool runTrial(const char* capturePath, Trial* trial, int index, void* extraDriverData)
+{
+    FMOD::Studio::System* system = createSystem(&trial->settings, &trial->memory, extraDriverData);
+
+    FMOD::Studio::CommandReplay* replay = NULL;
+    ERRCHECK( system->loadCommandReplay(capturePath, FMOD_STUDIO_COMMANDREPLAY_NORMAL, &replay) );
+
+    float totalTime = 0.0f;
+    ERRCHECK( replay->getLength(&totalTime) );
+    ERRCHECK( system->resetBufferUsage() );
+    ERRCHECK( replay->start() );
+    ERRCHECK( system->update() );
+
+    bool quit = false;
+    for (;;)
+    {
+        Common_Update();
+
+        if (Common_BtnPress(BTN_QUIT))
+        {
+            quit = true;
+            break;
+        }
+
+        FMOD_STUDIO_PLAYBACK_STATE state;
+        ERRCHECK( replay->getPlaybackState(&state) );
+        if (state == FMOD_STUDIO_PLAYBACK_STOPPED)
+        {
+            break;
+        }
+
+        int currentIndex = 0;
+        float currentTime = 0.0f;
+        ERRCHECK( replay->getCurrentCommand(&currentIndex, &currentTime) );
+
+        ERRCHECK( system->update() );
+
+        drawHeader();
+        Common_Draw("Trial %d: %s", index + 1, trial->reason);
+        Common_Draw("Queue %u bytes, handles %u, period %d ms", trial->settings.commandqueuesize, trial->settings.handleinitialsize, trial->settings.studioupdateperiod);
+        Common_Draw("Replaying %.1f / %.1f s", currentTime, totalTime);
+        Common_Draw("");
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+
+        Common_Sleep(50);
+    }
+
+    ERRCHECK( system->getBufferUsage(&trial->usage) );
+
+    ERRCHECK( replay->release() );
+    ERRCHECK( system->unloadAll() );
+    ERRCHECK( system->release() );
+
+    return !quit;
+}
+
+bool hasStalls(const Trial& trial)
+{
+    return trial.usage.studiocommandqueue.stallcount > 0 || trial.usage.studiohandle.stallcount > 0;
+}
+
+// Work out the next candidate from the last trial, returns false when tuning is finished
+bool nextCandidate(const Trial& last, bool* shrunk, Trial* next)
+{
+    *next = last;
+    memset(&next->usage, 0, sizeof(next->usage));
+
+    if (hasStalls(last))
+    {
+        if (*shrunk)
+        {
+            return false;   // The shrunk sizes were too tight, the best earlier trial stands
+        }
+
+        if (last.usage.studiocommandqueue.stallcount > 0)
+        {
+            if (last.settings.commandqueuesize * 2 <= QUEUE_MAX)
+            {
+                next->settings.commandqueuesize *= 2;
+                next->reason = "queue stalled, doubling";
+            }
+            else if (last.settings.studioupdateperiod / 2 >= UPDATE_PERIOD_MIN)
+            {
+                next->settings.studioupdateperiod /= 2;
+                next->reason = "queue at limit, halving period";
+            }
+            else
+            {
+                return false;
+            }
+        }
+        if (last.usage.studiohandle.stallcount > 0)
+        {
+            next->settings.handleinitialsize *= 2;
+            next->reason = "handles stalled, doubling";
+        }
+        return true;
+    }
+
+    if (*shrunk)
+    {
+        return false;
+    }
+
+    *shrunk = true;
+    unsigned int queue = last.usage.studiocommandqueue.peakusage * (100 + MARGIN_PERCENT) / 100;
+    unsigned int handles = last.usage.studiohandle.peakusage * (100 + MARGIN_PERCENT) / 100;
+    next->settings.commandqueuesize = Common_Max(QUEUE_MIN, roundUp(queue, QUEUE_GRANULARITY));
+    next->settings.handleinitialsize = Common_Max(HANDLE_GRANULARITY, roundUp(handles, HANDLE_GRANULARITY));
+    next->reason = "no stalls, shrinking to peak";
+
+    return next->settings.commandqueuesize < last.settings.commandqueuesize ||
+           next->settings.handleinitialsize < last.settings.handleinitialsize;
+}
+
+void writeProfile(const char* path, const Trial& best)
+{
+    FILE* file = fopen(path, "w");
+    if (!file)
+    {
+        return;
+    }
+
+    fprintf(file, "; Generated by the FMOD Studio settings tuner example for %s\n", TUNER_PLATFORM);
+    fprintf(file, "; Apply with Studio::System::setAdvancedSettings before Studio::System::initialize\n");
+    fprintf(file, "[studioadvancedsettings]\n");
+    fprintf(file, "commandqueuesize = %u\n", best.settings.commandqueuesize);
+    fprintf(file, "handleinitialsize = %u\n", best.settings.handleinitialsize);
+    fprintf(file, "studioupdateperiod = %d\n", best.settings.studioupdateperiod);
+    fprintf(file, "idlesampledatapoolsize = %d\n", best.settings.idlesampledatapoolsize);
+    fprintf(file, "streamingscheduledelay = %u\n", best.settings.streamingscheduledelay);
+    fprintf(file, "\n[measured]\n");
+    fprintf(file, "commandqueuepeak = %d\n", best.usage.studiocommandqueue.peakusage);
+    fprintf(file, "handlepeak = %d\n", best.usage.studiohandle.peakusage);
+    fprintf(file, "initializebytes = %d\n", best.memory);
+
+    fclose(file);
+}
+
+int FMOD_Main()
+{
+    void *extraDriverData = 0;
+    Common_Init(&extraDriverData);
+
+    // Prefer a capture recorded by hand, fall back to the scripted session
+    const char* capturePath = Common_WritePath(RECORDED_CAPTURE);
+    bool ok = true;
+    if (!fileExists(capturePath))
+    {
+        capturePath = Common_WritePath(SCRIPTED_CAPTURE);
+        ok = recordScript(capturePath, extraDriverData);
+    }
+
+    // Start from the defaults
+    Trial trials[MAX_TRIALS];
+    memset(trials, 0, sizeof(trials));
+    {
+        FMOD::Studio::System* system = NULL;
+        ERRCHECK( FMOD::Studio::System::create(&system) );
+        trials[0].settings.cbsize = sizeof(FMOD_STUDIO_ADVANCEDSETTINGS);
+        ERRCHECK( system->getAdvancedSettings(&trials[0].settings) );
+        ERRCHECK( system->release() );
+        trials[0].reason = "defaults";
+    }
+
+    int numTrials = 0;
+    bool shrunk = false;
+    while (ok && numTrials < MAX_TRIALS)
+    {
+        ok = runTrial(capturePath, &trials[numTrials], numTrials, extraDriverData);
+        numTrials++;
+
+        if (!ok || numTrials == MAX_TRIALS || !nextCandidate(trials[numTrials - 1], &shrunk, &trials[numTrials]))
+        {
+            break;
+        }
+    }
+
+    int best = -1;
+    for (int i = 0; i < numTrials; i++)
+    {
+        if (!hasStalls(trials[i]) && (best < 0 || trials[i].memory < trials[best].memory))
+        {
+            best = i;
+        }
+    }
+
+    char profileName[64];
+    Common_Format(profileName, sizeof(profileName), "studio_settings_%s.txt", TUNER_PLATFORM);
+    if (ok && best >= 0)
+    {
+        writeProfile(Common_WritePath(profileName), trials[best]);
+    }
+
+    while (ok)
+    {
+        Common_Update();
+
+        if (Common_BtnPress(BTN_QUIT))
+        {
+            break;
+        }
+
+        drawHeader();
+        Common_Draw("   Queue  Handles  Period Stalls  QPeak HPeak  KB");
+        for (int i = 0; i < numTrials; i++)
+        {
+            const Trial& t = trials[i];
+            Common_Draw("%c%7u %8u %7d %6d %6d %5d %4d", i == best ? '>' : ' ',
+                t.settings.commandqueuesize, t.settings.handleinitialsize, t.settings.studioupdateperiod,
+                t.usage.studiocommandqueue.stallcount + t.usage.studiohandle.stallcount,
+                t.usage.studiocommandqueue.peakusage, t.usage.studiohandle.peakusage, t.memory / 1024);
+        }
+        Common_Draw("");
+        if (best >= 0)
+        {
+            Common_Draw("Profile written to %s", profileName);
+        }
+        else
+        {
+            Common_Draw("No candidate replayed without stalls");
+        }
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+
+        Common_Sleep(50);
+    }
+
+    Common_Close();
+
+    return 0;
+}
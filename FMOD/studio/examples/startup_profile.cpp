@@ -0,0 +1,437 @@
+/*==============================================================================
+Startup Profile Example
+Copyright (c), Firelight Technologies Pty, Ltd 2012-2025.
+
+This example demonstrates measuring the audio startup sequence step by step
+and moving the steps that do not depend on each other off the main thread.
+
+The usual startup (create, set the software format, initialize, load
+plugins, load the master and strings banks, load a content bank, start the
+first event) is run twice:
+
+* Sequential: every step on the main thread, one after another, the way the
+  other Studio examples start up.
+* Parallel: the master and strings banks are read into memory on a worker
+  thread from the very start, while the system is created and initialized.
+  Plugins are loaded on a second worker once the core system exists. The
+  banks are then loaded from memory.
+
+System::loadPlugin takes the same FMOD API lock as initialize, so the
+plugin worker mostly waits for initialize to finish rather than running
+alongside it. Its step is timed on the worker and includes that wait.
+
+Each step is timed where it runs. The critical path is worked out from
+those durations and the dependencies declared in STEPS, not from measured
+overlap, and does not account for FMOD's internal locking. Time to first
+sound is measured up to the first event reporting
+FMOD_STUDIO_PLAYBACK_PLAYING. The second and later runs read the banks from
+the OS file cache, press the button again to compare warm runs.
+
+Plugins are loaded from fmod_gain.dll and fmod_distance_filter.dll next to
+the executable (built by the core examples), a missing plugin is reported
+and does not stop the startup.
+
+### See Also ###
+* Studio::System::loadBankMemory
+* System::loadPlugin
+
+For information on using FMOD example code in your own programs, visit
+https://www.fmod.com/legal
+==============================================================================*/
+#include "fmod_studio.hpp"
+#include "fmod.hpp"
+#include "common.h"
+
+static const char* PLUGIN_NAMES[] =
+{
+    "fmod_gain" COMMON_PLUGIN_SUFFIX ".dll",
+    "fmod_distance_filter" COMMON_PLUGIN_SUFFIX ".dll",
+};
+static const int PLUGIN_COUNT = sizeof(PLUGIN_NAMES) / sizeof(PLUGIN_NAMES[0]);
+
+static const char* PREFETCH_BANKS[] = { "Master.bank", "Master.strings.bank" };
+static const char* FIRST_EVENT = "event:/Ambience/Country";
+
+//
+// Startup steps, in an order that satisfies their dependencies
+//
+enum StartupStep
+{
+    STEP_CREATE,
+    STEP_FORMAT,
+    STEP_INITIALIZE,
+    STEP_PLUGINS,
+    STEP_READ_MASTER,
+    STEP_READ_STRINGS,
+    STEP_LOAD_MASTER,
+    STEP_LOAD_STRINGS,
+    STEP_LOAD_SFX,
+    STEP_FIRST_SOUND,
+    STEP_COUNT
+};
+
+#define STEP_BIT(_step) (1 << (_step))
+
+struct StepInfo
+{
+    const char*  name;
+    unsigned int dependencies;      // STEP_BIT mask of steps that must finish first
+};
+
+static const StepInfo STEPS[STEP_COUNT] =
+{
+    { "Create",          0 },
+    { "Software format", STEP_BIT(STEP_CREATE) },
+    { "Initialize",      STEP_BIT(STEP_FORMAT) },
+    { "Load plugins",    STEP_BIT(STEP_CREATE) },
+    { "Read master",     0 },
+    { "Read strings",    0 },
+    { "Load master",     STEP_BIT(STEP_INITIALIZE) | STEP_BIT(STEP_READ_MASTER) },
+    { "Load strings",    STEP_BIT(STEP_INITIALIZE) | STEP_BIT(STEP_READ_STRINGS) },
+    { "Load SFX",        STEP_BIT(STEP_INITIALIZE) },
+    { "First sound",     STEP_BIT(STEP_PLUGINS) | STEP_BIT(STEP_LOAD_MASTER) | STEP_BIT(STEP_LOAD_STRINGS) | STEP_BIT(STEP_LOAD_SFX) },
+};
+
+struct StepTiming
+{
+    unsigned int start;             // Microseconds since the startup began
+    unsigned int end;
+    char         thread;            // 'M' main, 'R' read worker, 'P' plugin worker, 'S' Studio bank loading
+};
+
+struct StartupProfile
+{
+    StepTiming   step[STEP_COUNT];
+    unsigned int criticalPath;      // STEP_BIT mask of the steps on the critical path
+    unsigned int criticalUs;
+    unsigned int firstSoundUs;
+    int          missingPlugins;
+};
+
+struct StartupState
+{
+    unsigned int    startTime;
+    StartupProfile* profile;
+
+    // Read worker, paths resolved on the main thread since Common_MediaPath is not thread safe
+    const char*     bankPath[2];
+    char*           bankData[2];
+    int             bankLength[2];
+    volatile bool   readDone;
+
+    // Plugin worker
+    FMOD::System*   coreSystem;
+    volatile bool   pluginsDone;
+};
+
+void beginStep(StartupState* state, StartupStep step, char thread)
+{
+    unsigned int now;
+    Common_Time_GetUs(&now);
+    state->profile->step[step].start = now - state->startTime;
+    state->profile->step[step].thread = thread;
+}
+
+void endStep(StartupState* state, StartupStep step)
+{
+    unsigned int now;
+    Common_Time_GetUs(&now);
+    state->profile->step[step].end = now - state->startTime;
+}
+
+//
+// Steps that can run off the main thread
+//
+void readBanks(StartupState* state, char thread)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        beginStep(state, (StartupStep)(STEP_READ_MASTER + i), thread);
+        Common_LoadFileMemory(state->bankPath[i], (void**)&state->bankData[i], &state->bankLength[i]);
+        endStep(state, (StartupStep)(STEP_READ_MASTER + i));
+    }
+}
+
+void loadPlugins(StartupState* state, char thread)
+{
+    beginStep(state, STEP_PLUGINS, thread);
+    for (int i = 0; i < PLUGIN_COUNT; i++)
+    {
+        unsigned int handle;
+        if (state->coreSystem->loadPlugin(PLUGIN_NAMES[i], &handle) != FMOD_OK)
+        {
+            state->profile->missingPlugins++;
+        }
+    }
+    endStep(state, STEP_PLUGINS);
+}
+
+void readThread(void* param)
+{
+    StartupState* state = (StartupState*)param;
+    readBanks(state, 'R');
+    state->readDone = true;
+}
+
+void pluginThread(void* param)
+{
+    StartupState* state = (StartupState*)param;
+    loadPlugins(state, 'P');
+    state->pluginsDone = true;
+}
+
+void waitFor(volatile bool* done)
+{
+    while (!*done)
+    {
+        Common_Sleep(1);
+    }
+}
+
+// Ends the step the first time the bank is seen out of the loading state
+bool checkBankLoaded(StartupState* state, FMOD::Studio::Bank* bank, StartupStep step)
+{
+    FMOD_STUDIO_LOADING_STATE loadingState;
+    ERRCHECK( bank->getLoadingState(&loadingState) );
+    if (loadingState == FMOD_STUDIO_LOADING_STATE_LOADING)
+    {
+        return false;
+    }
+    endStep(state, step);
+    return true;
+}
+
+//
+// Longest path through the dependency graph using the measured durations
+//
+void findCriticalPath(StartupProfile* profile)
+{
+    unsigned int finish[STEP_COUNT];
+    int          previous[STEP_COUNT];
+
+    for (int i = 0; i < STEP_COUNT; i++)
+    {
+        unsigned int earliest = 0;
+        previous[i] = -1;
+
+        for (int d = 0; d < i; d++)
+        {
+            if ((STEPS[i].dependencies & STEP_BIT(d)) && finish[d] > earliest)
+            {
+                earliest = finish[d];
+                previous[i] = d;
+            }
+        }
+        finish[i] = earliest + (profile->step[i].end - profile->step[i].start);
+    }
+
+    profile->criticalUs = finish[STEP_FIRST_SOUND];
+    profile->criticalPath = 0;
+    for (int i = STEP_FIRST_SOUND; i >= 0; i = previous[i])
+    {
+        profile->criticalPath |= STEP_BIT(i);
+    }
+}
+
+//
+// Run the whole startup. The system and the first event instance are left running.
+//
+void runStartup(bool parallel, void* extraDriverData, StartupProfile* profile, FMOD::Studio::System** outSystem, FMOD::Studio::EventInstance** outInstance)
+{
+    StartupState state;
+    void*        readHandle = NULL;
+    void*        pluginHandle = NULL;
+
+    memset(profile, 0, sizeof(StartupProfile));
+    memset(&state, 0, sizeof(state));
+    state.profile = profile;
+    for (int i = 0; i < 2; i++)
+    {
+        state.bankPath[i] = Common_MediaPath(PREFETCH_BANKS[i]);
+    }
+    const char* sfxPath = Common_MediaPath("SFX.bank");
+    Common_Time_GetUs(&state.startTime);
+
+    if (parallel)
+    {
+        // No dependencies, start reading before anything else
+        Common_Thread_Create(readThread, &state, &readHandle);
+    }
+
+    FMOD::Studio::System* system = NULL;
+    beginStep(&state, STEP_CREATE, 'M');
+    ERRCHECK( FMOD::Studio::System::create(&system) );
+    ERRCHECK( system->getCoreSystem(&state.coreSystem) );
+    endStep(&state, STEP_CREATE);
+
+    if (parallel)
+    {
+        // Only needs the core system to exist, but waits on the API lock while initialize runs
+        Common_Thread_Create(pluginThread, &state, &pluginHandle);
+    }
+
+    // The example Studio project is authored for 5.1 sound, so set up the system output mode to match
+    beginStep(&state, STEP_FORMAT, 'M');
+    ERRCHECK( state.coreSystem->setSoftwareFormat(0, FMOD_SPEAKERMODE_5POINT1, 0) );
+    endStep(&state, STEP_FORMAT);
+
+    beginStep(&state, STEP_INITIALIZE, 'M');
+    ERRCHECK( system->initialize(1024, FMOD_STUDIO_INIT_NORMAL, FMOD_INIT_NORMAL, extraDriverData) );
+    endStep(&state, STEP_INITIALIZE);
+
+    FMOD::Studio::Bank* sfxBank = NULL;
+    bool sfxLoaded = false;
+    if (parallel)
+    {
+        // Content bank loads asynchronously while the master banks are read and created from memory. Its loading
+        // state is polled in between so the step ends when the bank finished, not when the main thread got to it.
+        beginStep(&state, STEP_LOAD_SFX, 'S');
+        ERRCHECK( system->loadBankFile(sfxPath, FMOD_STUDIO_LOAD_BANK_NONBLOCKING, &sfxBank) );
+        while (!state.readDone)
+        {
+            sfxLoaded = sfxLoaded || checkBankLoaded(&state, sfxBank, STEP_LOAD_SFX);
+            Common_Sleep(1);
+        }
+    }
+    else
+    {
+        loadPlugins(&state, 'M');
+        readBanks(&state, 'M');
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+        FMOD::Studio::Bank* bank = NULL;
+        beginStep(&state, (StartupStep)(STEP_LOAD_MASTER + i), 'M');
+        ERRCHECK( system->loadBankMemory(state.bankData[i], state.bankLength[i], FMOD_STUDIO_LOAD_MEMORY, FMOD_STUDIO_LOAD_BANK_NORMAL, &bank) );
+        endStep(&state, (StartupStep)(STEP_LOAD_MASTER + i));
+        Common_UnloadFileMemory(state.bankData[i]);
+
+        // A master bank load blocks, so a content bank that finished during it is seen at its end
+        if (parallel && !sfxLoaded)
+        {
+            sfxLoaded = checkBankLoaded(&state, sfxBank, STEP_LOAD_SFX);
+        }
+    }
+
+    if (parallel)
+    {
+        while (!sfxLoaded)
+        {
+            Common_Sleep(1);
+            sfxLoaded = checkBankLoaded(&state, sfxBank, STEP_LOAD_SFX);
+        }
+        waitFor(&state.pluginsDone);
+
+        Common_Thread_Destroy(readHandle);
+        Common_Thread_Destroy(pluginHandle);
+    }
+    else
+    {
+        beginStep(&state, STEP_LOAD_SFX, 'M');
+        ERRCHECK( system->loadBankFile(sfxPath, FMOD_STUDIO_LOAD_BANK_NORMAL, &sfxBank) );
+        endStep(&state, STEP_LOAD_SFX);
+    }
+
+    // First sound, counted until Studio reports the instance as playing
+    FMOD::Studio::EventDescription* description = NULL;
+    FMOD::Studio::EventInstance* instance = NULL;
+    beginStep(&state, STEP_FIRST_SOUND, 'M');
+    ERRCHECK( system->getEvent(FIRST_EVENT, &description) );
+    ERRCHECK( description->createInstance(&instance) );
+    ERRCHECK( instance->start() );
+
+    FMOD_STUDIO_PLAYBACK_STATE playbackState = FMOD_STUDIO_PLAYBACK_STARTING;
+    while (playbackState != FMOD_STUDIO_PLAYBACK_PLAYING)
+    {
+        ERRCHECK( system->update() );
+        ERRCHECK( instance->getPlaybackState(&playbackState) );
+        if (playbackState != FMOD_STUDIO_PLAYBACK_PLAYING)
+        {
+            Common_Sleep(1);
+        }
+    }
+    endStep(&state, STEP_FIRST_SOUND);
+
+    profile->firstSoundUs = profile->step[STEP_FIRST_SOUND].end;
+    findCriticalPath(profile);
+
+    *outSystem = system;
+    *outInstance = instance;
+}
+
+void shutdown(FMOD::Studio::System* system, FMOD::Studio::EventInstance* instance)
+{
+    ERRCHECK( instance->stop(FMOD_STUDIO_STOP_IMMEDIATE) );
+    ERRCHECK( instance->release() );
+    ERRCHECK( system->release() );
+}
+
+//
+// Main example code
+//
+int FMOD_Main()
+{
+    void *extraDriverData = NULL;
+    Common_Init(&extraDriverData);
+
+    StartupProfile profile[2];      // [0] sequential, [1] parallel
+    FMOD::Studio::System* system = NULL;
+    FMOD::Studio::EventInstance* instance = NULL;
+
+    runStartup(false, extraDriverData, &profile[0], &system, &instance);
+    shutdown(system, instance);
+    runStartup(true, extraDriverData, &profile[1], &system, &instance);
+
+    do
+    {
+        Common_Update();
+
+        if (Common_BtnPress(BTN_ACTION1))
+        {
+            shutdown(system, instance);
+            runStartup(false, extraDriverData, &profile[0], &system, &instance);
+            shutdown(system, instance);
+            runStartup(true, extraDriverData, &profile[1], &system, &instance);
+        }
+
+        ERRCHECK( system->update() );
+
+        Common_Draw("==================================================");
+        Common_Draw("Startup Profile Example.");
+        Common_Draw("Copyright (c) Firelight Technologies 2012-2025.");
+        Common_Draw("==================================================");
+        Common_Draw("Press %s to run both startups again", Common_BtnStr(BTN_ACTION1));
+        Common_Draw("Press %s to quit", Common_BtnStr(BTN_QUIT));
+        Common_Draw("");
+        Common_Draw("Step (* critical)   Seq ms   Par ms  @ms  Thr");
+        for (int i = 0; i < STEP_COUNT; i++)
+        {
+            const StepTiming& sequential = profile[0].step[i];
+            const StepTiming& parallel = profile[1].step[i];
+
+            Common_Draw("%c%-16s %8.1f %8.1f %5.0f  %c",
+                (profile[1].criticalPath & STEP_BIT(i)) ? '*' : ' ',
+                STEPS[i].name,
+                (sequential.end - sequential.start) / 1000.0f,
+                (parallel.end - parallel.start) / 1000.0f,
+                parallel.start / 1000.0f,
+                parallel.thread);
+        }
+        Common_Draw("");
+        Common_Draw("Time to first sound  %8.1f %8.1f ms", profile[0].firstSoundUs / 1000.0f, profile[1].firstSoundUs / 1000.0f);
+        Common_Draw("Critical path        %8.1f %8.1f ms", profile[0].criticalUs / 1000.0f, profile[1].criticalUs / 1000.0f);
+        if (profile[1].missingPlugins)
+        {
+            Common_Draw("%d plugin(s) not found next to the executable", profile[1].missingPlugins);
+        }
+
+        Common_Sleep(50);
+    } while (!Common_BtnPress(BTN_QUIT));
+
+    shutdown(system, instance);
+
+    Common_Close();
+
+    return 0;
+}